@@ -6,35 +6,92 @@
 #include "item.h"
 #include "safe_reference.h"
 
-void active_item_cache::remove( const item *it )
+// Removes the broken references and those to it
+static void erase_references( std::vector<item_reference> &refs, const item *it )
 {
-    active_items[it->processing_speed()].remove_if( [it]( const item_reference & active_item ) {
+    const auto removed = std::remove_if( refs.begin(), refs.end(),
+    [it]( const item_reference & active_item ) {
         item *const target = active_item.item_ref.get();
         return !target || target == it;
     } );
+    refs.erase( removed, refs.end() );
+}
+
+bool active_item_cache::is_cached_at( const item *it, const queue_position &pos ) const
+{
+    const auto queue = active_items.find( pos.speed );
+    return queue != active_items.end() && pos.index < queue->second.items.size() &&
+           queue->second.items[pos.index].item_ref.get() == it;
+}
+
+void active_item_cache::move_item( item_queue &queue, size_t from, size_t to )
+{
+    if( from == to ) {
+        return;
+    }
+    queue.items[to] = std::move( queue.items[from] );
+    if( const item *moved = queue.items[to].item_ref.get() ) {
+        positions[moved].index = to;
+    }
+}
+
+// The item before next takes the place of the erased one and the last item takes its place,
+// so the items returned in this round of the queue stay before next
+void active_item_cache::erase_at( item_queue &queue, size_t index )
+{
+    if( index < queue.next ) {
+        --queue.next;
+        move_item( queue, queue.next, index );
+        index = queue.next;
+    }
+    move_item( queue, queue.items.size() - 1, index );
+    queue.items.pop_back();
+    --cached_count;
+}
+
+// Drops the broken references and keeps the order of the others
+void active_item_cache::prune( item_queue &queue )
+{
+    size_t kept = 0;
+    size_t next = 0;
+    for( size_t i = 0; i < queue.items.size(); ++i ) {
+        if( !queue.items[i].item_ref ) {
+            continue;
+        }
+        if( i < queue.next ) {
+            ++next;
+        }
+        move_item( queue, i, kept );
+        ++kept;
+    }
+    cached_count -= queue.items.size() - kept;
+    queue.items.resize( kept );
+    queue.next = next;
+}
+
+void active_item_cache::remove( const item *it )
+{
+    const auto found = positions.find( it );
+    if( found != positions.end() ) {
+        if( is_cached_at( it, found->second ) ) {
+            erase_at( active_items[found->second.speed], found->second.index );
+        }
+        positions.erase( found );
+    }
     if( it->can_revive() ) {
-        special_items[ special_item_type::corpse ].remove_if( [it]( const item_reference & active_item ) {
-            item *const target = active_item.item_ref.get();
-            return !target || target == it;
-        } );
+        erase_references( special_items[ special_item_type::corpse ], it );
     }
     if( it->get_use( "explosion" ) ) {
-        special_items[ special_item_type::explosive ].remove_if( [it]( const item_reference &
-        active_item ) {
-            item *const target = active_item.item_ref.get();
-            return !target || target == it;
-        } );
+        erase_references( special_items[ special_item_type::explosive ], it );
     }
 }
 
 void active_item_cache::add( item &it, point location )
 {
-    // If the item is already in the cache for some reason, don't add a second reference
-    std::list<item_reference> &target_list = active_items[it.processing_speed()];
-    if( std::find_if( target_list.begin(),
-    target_list.end(), [&it]( const item_reference & active_item_ref ) {
-    return &it == active_item_ref.item_ref.get();
-    } ) != target_list.end() ) {
+    // If the item is already in the cache for some reason, don't add a second reference.
+    // The position may also be left over from a destroyed item at the same address.
+    const auto found = positions.find( &it );
+    if( found != positions.end() && is_cached_at( &it, found->second ) ) {
         return;
     }
     if( it.can_revive() ) {
@@ -43,28 +100,37 @@ void active_item_cache::add( item &it, point location )
     if( it.get_use( "explosion" ) ) {
         special_items[ special_item_type::explosive ].push_back( item_reference{ location, it.get_safe_reference() } );
     }
-    target_list.push_back( item_reference{ location, it.get_safe_reference() } );
+    const int speed = std::max( it.processing_speed(), 1 );
+    item_queue &queue = active_items[speed];
+    queue.items.push_back( item_reference{ location, it.get_safe_reference() } );
+    positions[&it] = queue_position{ speed, queue.items.size() - 1 };
+    ++cached_count;
 }
 
 bool active_item_cache::empty() const
 {
-    return std::all_of( active_items.begin(), active_items.end(), []( const auto & active_queue ) {
-        return active_queue.second.empty();
-    } );
+    return cached_count == 0;
+}
+
+void active_item_cache::rebuild_positions()
+{
+    positions.clear();
+    for( std::pair<const int, item_queue> &kv : active_items ) {
+        prune( kv.second );
+        for( size_t i = 0; i < kv.second.items.size(); ++i ) {
+            positions[kv.second.items[i].item_ref.get()] = queue_position{ kv.first, i };
+        }
+    }
 }
 
 std::vector<item_reference> active_item_cache::get()
 {
     std::vector<item_reference> all_cached_items;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        for( std::list<item_reference>::iterator it = kv.second.begin(); it != kv.second.end(); ) {
-            if( it->item_ref ) {
-                all_cached_items.emplace_back( *it );
-                ++it;
-            } else {
-                it = kv.second.erase( it );
-            }
-        }
+    all_cached_items.reserve( cached_count );
+    for( std::pair<const int, item_queue> &kv : active_items ) {
+        prune( kv.second );
+        all_cached_items.insert( all_cached_items.end(), kv.second.items.begin(),
+                                 kv.second.items.end() );
     }
     return all_cached_items;
 }
@@ -72,40 +138,47 @@ std::vector<item_reference> active_item_cache::get()
 std::vector<item_reference> active_item_cache::get_for_processing()
 {
     std::vector<item_reference> items_to_process;
-    for( std::pair<const int, std::list<item_reference>> &kv : active_items ) {
-        // Rely on iteration logic to make sure the number is sane.
-        int num_to_process = kv.second.size() / kv.first;
-        std::list<item_reference>::iterator it = kv.second.begin();
-        for( ; it != kv.second.end() && num_to_process >= 0; ) {
-            if( it->item_ref ) {
-                items_to_process.push_back( *it );
-                --num_to_process;
-                ++it;
+    for( std::pair<const int, item_queue> &kv : active_items ) {
+        item_queue &queue = kv.second;
+        const size_t size = queue.items.size();
+        const size_t num_to_process = std::min( size / kv.first + 1, size );
+        size_t processed = 0;
+        bool found_broken = false;
+        // Every item is looked at once at most, in case most references are broken
+        for( size_t i = 0; i < size && processed < num_to_process; ++i ) {
+            if( queue.next >= size ) {
+                queue.next = 0;
+            }
+            const item_reference &ref = queue.items[queue.next++];
+            if( ref.item_ref ) {
+                items_to_process.push_back( ref );
+                ++processed;
             } else {
-                // The item has been destroyed, so remove the reference from the cache
-                it = kv.second.erase( it );
+                found_broken = true;
             }
         }
-        // Rotate the returned items to the end of their list so that the items that weren't
-        // returned this time will be first in line on the next call
-        kv.second.splice( kv.second.end(), kv.second, kv.second.begin(), it );
+        // Items that have been destroyed are removed from the cache
+        if( found_broken ) {
+            prune( queue );
+        }
+    }
+    // Items destroyed without being removed leave their positions behind, drop them once
+    // they outnumber the cached items
+    if( positions.size() > 2 * cached_count + 64 ) {
+        rebuild_positions();
     }
     return items_to_process;
 }
 
 std::vector<item_reference> active_item_cache::get_special( special_item_type type )
 {
-    std::vector<item_reference> matching_items;
-    for( const item_reference &it : special_items[type] ) {
-        matching_items.push_back( it );
-    }
-    return matching_items;
+    return special_items[type];
 }
 
 void active_item_cache::subtract_locations( const point &delta )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
+    for( std::pair<const int, item_queue> &kv : active_items ) {
+        for( item_reference &ir : kv.second.items ) {
             ir.location -= delta;
         }
     }
@@ -113,8 +186,8 @@ void active_item_cache::subtract_locations( const point &delta )
 
 void active_item_cache::rotate_locations( int turns, const point &dim )
 {
-    for( std::pair<const int, std::list<item_reference>> &pair : active_items ) {
-        for( item_reference &ir : pair.second ) {
+    for( std::pair<const int, item_queue> &kv : active_items ) {
+        for( item_reference &ir : kv.second.items ) {
             ir.location = ir.location.rotate( turns, dim );
         }
     }
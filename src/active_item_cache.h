@@ -3,7 +3,6 @@
 #define CATA_SRC_ACTIVE_ITEM_CACHE_H
 
 #include <cstddef>
-#include <list>
 #include <unordered_map>
 #include <vector>
 
@@ -37,14 +36,36 @@ struct hash<special_item_type> {
 class active_item_cache
 {
     private:
-        std::unordered_map<int, std::list<item_reference>> active_items;
-        std::unordered_map<special_item_type, std::list<item_reference>> special_items;
+        /**
+         * The items of one processing speed, returned by get_for_processing() in turn.
+         * The items before @ref next were returned since the queue last went round.
+         */
+        struct item_queue {
+            std::vector<item_reference> items;
+            size_t next = 0;
+        };
+        struct queue_position {
+            int speed;
+            size_t index;
+        };
+        std::unordered_map<int, item_queue> active_items;
+        // Position of every cached item, so adding and removing one does not search the cache.
+        // Entries of destroyed items are left behind until rebuild_positions() drops them.
+        std::unordered_map<const item *, queue_position> positions;
+        std::unordered_map<special_item_type, std::vector<item_reference>> special_items;
+        // References in the queues, including the broken ones not pruned yet
+        size_t cached_count = 0;
+
+        bool is_cached_at( const item *it, const queue_position &pos ) const;
+        void move_item( item_queue &queue, size_t from, size_t to );
+        void erase_at( item_queue &queue, size_t index );
+        void prune( item_queue &queue );
+        void rebuild_positions();
 
     public:
         /**
          * Removes the item if it is in the cache. Does nothing if the item is not in the cache.
          * Relies on the fact that item::processing_speed() is a constant.
-         * Also removes any items that have been destroyed in the list containing it
          */
         void remove( const item *it );
 
@@ -66,9 +87,9 @@ class active_item_cache
         std::vector<item_reference> get();
 
         /**
-         * Returns the first size() / processing_speed() elements of each list, rounded up.
-         * Items returned are rotated to the back of their respective lists, otherwise only the
-         * first n items will ever be processed.
+         * Returns the next size() / processing_speed() + 1 items of each queue, so each of k items
+         * is returned every k calls as long as k is below the processing speed, and a bit more
+         * often than every processing_speed() calls for more items.
          * Broken references encountered when collecting the items to be processed are removed from
          * the cache.
          * Relies on the fact that item::processing_speed() is a constant.
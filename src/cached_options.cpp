@@ -1,9 +1,11 @@
 #include "cached_options.h"
 
+int data_loading_threads = 4;
 bool fov_3d;
 int fov_3d_z_range;
 bool keycode_mode;
 bool log_from_top;
+int map_cache_threads = 1;
 int message_ttl;
 int message_cooldown;
 bool test_mode;
@@ -6,10 +6,12 @@
 // They should be updated when the corresponding option is changed (in
 // options.cpp).
 
+extern int data_loading_threads;
 extern bool fov_3d;
 extern int fov_3d_z_range;
 extern bool keycode_mode;
 extern bool log_from_top;
+extern int map_cache_threads;
 extern int message_ttl;
 extern int message_cooldown;
 extern bool tile_iso;
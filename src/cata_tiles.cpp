@@ -1321,9 +1321,10 @@ void cata_tiles::draw( const point &dest, const tripoint &center, int width, int
                 } else {
                     color = catacurses::blue + bold;
                 }
-                if( get_option<std::string>( "USE_CELSIUS" ) == "celsius" ) {
+                static const option_handle<std::string> use_celsius( "USE_CELSIUS" );
+                if( use_celsius.value() == "celsius" ) {
                     temp_value = temp_to_celsius( temp_value );
-                } else if( get_option<std::string>( "USE_CELSIUS" ) == "kelvin" ) {
+                } else if( use_celsius.value() == "kelvin" ) {
                     temp_value = temp_to_kelvin( temp_value );
 
                 }
@@ -13,6 +13,7 @@
 #include <string>
 
 #include "catacharset.h"
+#include "compression.h"
 #include "debug.h"
 #include "filesystem.h"
 #include "json.h"
@@ -280,18 +281,37 @@ float multi_lerp( const std::vector<std::pair<float, float>> &points, float x )
 }
 
 void write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer )
+{
+    write_to_file( path, writer, file_compression::none );
+}
+
+void write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
+                    const file_compression compression )
 {
     // Any of the below may throw. ofstream_wrapper will clean up the temporary path on its own.
     ofstream_wrapper fout( path, std::ios::binary );
-    writer( fout.stream() );
+    if( compression == file_compression::deflate ) {
+        deflate_streambuf buf( fout.stream() );
+        std::ostream zout( &buf );
+        writer( zout );
+        buf.finish();
+    } else {
+        writer( fout.stream() );
+    }
     fout.close();
 }
 
 bool write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
                     const char *const fail_message )
+{
+    return write_to_file( path, writer, fail_message, file_compression::none );
+}
+
+bool write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
+                    const char *const fail_message, const file_compression compression )
 {
     try {
-        write_to_file( path, writer );
+        write_to_file( path, writer, compression );
         return true;
 
     } catch( const std::exception &err ) {
@@ -345,6 +365,22 @@ std::istream &safe_getline( std::istream &ins, std::string &str )
     }
 }
 
+file_compression save_file_compression()
+{
+    return get_option<bool>( "COMPRESS_SAVES" ) ? file_compression::deflate : file_compression::none;
+}
+
+// Leaves the stream at its start
+static bool is_compressed_file( std::istream &fin )
+{
+    std::string start( 2, '\0' );
+    fin.read( &start[0], start.size() );
+    start.resize( fin.gcount() );
+    fin.clear();
+    fin.seekg( 0 );
+    return is_compressed_data( start );
+}
+
 bool read_from_file( const std::string &path, const std::function<void( std::istream & )> &reader )
 {
     try {
@@ -352,6 +388,20 @@ bool read_from_file( const std::string &path, const std::function<void( std::ist
         if( !fin ) {
             throw std::runtime_error( "opening file failed" );
         }
+        if( is_compressed_file( fin ) ) {
+            // Readers may seek, which a decompressing stream can not do cheaply
+            std::string data( ( std::istreambuf_iterator<char>( fin ) ),
+                              std::istreambuf_iterator<char>() );
+            if( fin.bad() ) {
+                throw std::runtime_error( "reading file failed" );
+            }
+            std::istringstream data_in( decompress_data( data ) );
+            reader( data_in );
+            if( data_in.bad() ) {
+                throw std::runtime_error( "reading file failed" );
+            }
+            return true;
+        }
         reader( fin );
         if( fin.bad() ) {
             throw std::runtime_error( "reading file failed" );
@@ -453,8 +503,7 @@ std::string serialize_wrapper( const std::function<void( JsonOut & )> &callback
 
 void deserialize_wrapper( const std::function<void( JsonIn & )> &callback, const std::string &data )
 {
-    std::istringstream buffer( data );
-    JsonIn jsin( buffer );
+    JsonIn jsin( data );
     callback( jsin );
 }
 
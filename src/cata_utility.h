@@ -294,6 +294,8 @@ class list_circularizer
         }
 };
 
+enum class file_compression : int;
+
 /**
  * Open a file for writing, calls the writer on that stream.
  *
@@ -301,6 +303,9 @@ class list_circularizer
  * happens, the function shows a popup containing the
  * \p fail_message, the error text and the path.
  *
+ * With @p compression, the data is compressed before it is written, see compression.h.
+ * Reading such files needs no special handling, @ref read_from_file detects them.
+ *
  * @return Whether saving succeeded (no error was caught).
  * @throw The void function throws when writing failes or when the @p writer throws.
  * The other function catches all exceptions and returns false.
@@ -308,16 +313,24 @@ class list_circularizer
 ///@{
 bool write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
                     const char *fail_message );
+bool write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
+                    const char *fail_message, file_compression compression );
 void write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer );
+void write_to_file( const std::string &path, const std::function<void( std::ostream & )> &writer,
+                    file_compression compression );
 ///@}
 
+/** Compression of the files of the current world, as chosen in its options. */
+file_compression save_file_compression();
+
 class JsonDeserializer;
 
 /**
  * Try to open and read from given file using the given callback.
  *
  * The file is opened for reading (binary mode), given to the callback (which does the actual
- * reading) and closed.
+ * reading) and closed. Compressed files are decompressed first, so the callback always gets
+ * the original data.
  * Any exceptions from the callbacks are caught and reported as `debugmsg`.
  * If the stream is in a fail state (other than EOF) after the callback returns, it is handled as
  * error as well.
@@ -4226,7 +4226,8 @@ std::string Character::enumerate_unmet_requirements( const item &it, const item
 
 int Character::rust_rate() const
 {
-    const std::string &rate_option = get_option<std::string>( "SKILL_RUST" );
+    static const option_handle<std::string> skill_rust( "SKILL_RUST" );
+    const std::string &rate_option = skill_rust.value();
     if( rate_option == "off" ) {
         return 0;
     }
@@ -4957,11 +4958,11 @@ int Character::get_int_bonus() const
 
 static int get_speedydex_bonus( const int dex )
 {
-    static const std::string speedydex_min_dex( "SPEEDYDEX_MIN_DEX" );
-    static const std::string speedydex_dex_speed( "SPEEDYDEX_DEX_SPEED" );
+    static const option_handle<int> speedydex_min_dex( "SPEEDYDEX_MIN_DEX" );
+    static const option_handle<int> speedydex_dex_speed( "SPEEDYDEX_DEX_SPEED" );
     // this is the number to be multiplied by the increment
-    const int modified_dex = std::max( dex - get_option<int>( speedydex_min_dex ), 0 );
-    return modified_dex * get_option<int>( speedydex_dex_speed );
+    const int modified_dex = std::max( dex - speedydex_min_dex.value(), 0 );
+    return modified_dex * speedydex_dex_speed.value();
 }
 
 int Character::get_enchantment_speed_bonus() const
@@ -5206,7 +5207,8 @@ std::string Character::debug_weary_info() const
 
 void Character::mod_stored_kcal( int nkcal, const bool ignore_weariness )
 {
-    const bool npc_no_food = is_npc() && get_option<bool>( "NO_NPC_FOOD" );
+    static const option_handle<bool> no_npc_food( "NO_NPC_FOOD" );
+    const bool npc_no_food = is_npc() && no_npc_food.value();
     if( !npc_no_food ) {
         mod_stored_calories( nkcal * 1000, ignore_weariness );
     }
@@ -5265,7 +5267,8 @@ int Character::get_hunger() const
 
 void Character::mod_hunger( int nhunger )
 {
-    const bool npc_no_food = is_npc() && get_option<bool>( "NO_NPC_FOOD" );
+    static const option_handle<bool> no_npc_food( "NO_NPC_FOOD" );
+    const bool npc_no_food = is_npc() && no_npc_food.value();
     if( !npc_no_food ) {
         set_hunger( hunger + nhunger );
     }
@@ -5379,7 +5382,8 @@ std::pair<std::string, nc_color> Character::get_fatigue_description() const
 
 void Character::mod_thirst( int nthirst )
 {
-    if( has_flag( json_flag_NO_THIRST ) || ( is_npc() && get_option<bool>( "NO_NPC_FOOD" ) ) ) {
+    static const option_handle<bool> no_npc_food( "NO_NPC_FOOD" );
+    if( has_flag( json_flag_NO_THIRST ) || ( is_npc() && no_npc_food.value() ) ) {
         return;
     }
     set_thirst( std::max( -100, thirst + nthirst ) );
@@ -5726,7 +5730,8 @@ int Character::weariness() const
 int Character::weary_threshold() const
 {
     const int bmr = base_bmr();
-    int threshold = bmr * get_option<float>( "WEARY_BMR_MULT" );
+    static const option_handle<float> weary_bmr_mult( "WEARY_BMR_MULT" );
+    int threshold = bmr * weary_bmr_mult.value();
     // reduce by 1% per 14 points of fatigue after 150 points
     threshold *= 1.0f - ( ( std::max( fatigue, -20 ) - 150 ) / 1400.0f );
     // Each 2 points of morale increase or decrease by 1%
@@ -5742,11 +5747,13 @@ std::pair<int, int> Character::weariness_transition_progress() const
     // Mostly a duplicate of the below function. No real way to clean this up
     int amount = weariness();
     int threshold = weary_threshold();
-    amount -= threshold * get_option<float>( "WEARY_INITIAL_STEP" );
+    static const option_handle<float> weary_initial_step( "WEARY_INITIAL_STEP" );
+    static const option_handle<float> weary_thresh_scaling( "WEARY_THRESH_SCALING" );
+    amount -= threshold * weary_initial_step.value();
     while( amount >= 0 ) {
         amount -= threshold;
         if( threshold > 20 ) {
-            threshold *= get_option<float>( "WEARY_THRESH_SCALING" );
+            threshold *= weary_thresh_scaling.value();
         }
     }
 
@@ -5760,11 +5767,13 @@ int Character::weariness_level() const
     int amount = weariness();
     int threshold = weary_threshold();
     int level = 0;
-    amount -= threshold * get_option<float>( "WEARY_INITIAL_STEP" );
+    static const option_handle<float> weary_initial_step( "WEARY_INITIAL_STEP" );
+    static const option_handle<float> weary_thresh_scaling( "WEARY_THRESH_SCALING" );
+    amount -= threshold * weary_initial_step.value();
     while( amount >= 0 ) {
         amount -= threshold;
         if( threshold > 20 ) {
-            threshold *= get_option<float>( "WEARY_THRESH_SCALING" );
+            threshold *= weary_thresh_scaling.value();
         }
         ++level;
     }
@@ -5824,7 +5833,8 @@ void Character::update_stomach( const time_point &from, const time_point &to )
     // No food/thirst/fatigue clock at all
     const bool debug_ls = has_trait( trait_DEBUG_LS );
     // No food/thirst, capped fatigue clock (only up to tired)
-    const bool npc_no_food = is_npc() && get_option<bool>( "NO_NPC_FOOD" );
+    static const option_handle<bool> no_npc_food( "NO_NPC_FOOD" );
+    const bool npc_no_food = is_npc() && no_npc_food.value();
     const bool foodless = debug_ls || npc_no_food;
     const bool no_thirst = has_flag( json_flag_NO_THIRST );
     const bool mycus = has_trait( trait_M_DEPENDENT );
@@ -5985,7 +5995,8 @@ void Character::update_needs( int rate_multiplier )
     // No food/thirst/fatigue clock at all
     const bool debug_ls = has_trait( trait_DEBUG_LS );
     // No food/thirst, capped fatigue clock (only up to tired)
-    const bool npc_no_food = is_npc() && get_option<bool>( "NO_NPC_FOOD" );
+    static const option_handle<bool> no_npc_food( "NO_NPC_FOOD" );
+    const bool npc_no_food = is_npc() && no_npc_food.value();
     const bool asleep = !sleep.is_null();
     const bool lying = asleep || has_effect( effect_lying_down ) ||
                        activity.id() == ACT_TRY_SLEEP;
@@ -6113,16 +6124,16 @@ needs_rates Character::calc_needs_rates() const
 
     add_msg_debug_if_player( debugmode::DF_CHAR_CALORIES, "Metabolic rate: %.2f", rates.hunger );
 
-    static const std::string player_thirst_rate( "PLAYER_THIRST_RATE" );
-    rates.thirst = get_option< float >( player_thirst_rate );
+    static const option_handle<float> player_thirst_rate( "PLAYER_THIRST_RATE" );
+    rates.thirst = player_thirst_rate.value();
     static const std::string thirst_modifier( "thirst_modifier" );
     rates.thirst *= 1.0f + mutation_value( thirst_modifier );
     if( worn_with_flag( flag_SLOWS_THIRST ) ) {
         rates.thirst *= 0.7f;
     }
 
-    static const std::string player_fatigue_rate( "PLAYER_FATIGUE_RATE" );
-    rates.fatigue = get_option< float >( player_fatigue_rate );
+    static const option_handle<float> player_fatigue_rate( "PLAYER_FATIGUE_RATE" );
+    rates.fatigue = player_fatigue_rate.value();
     static const std::string fatigue_modifier( "fatigue_modifier" );
     rates.fatigue *= 1.0f + mutation_value( fatigue_modifier );
 
@@ -8175,11 +8186,13 @@ float Character::mutation_value( const std::string &val ) const
 float Character::healing_rate( float at_rest_quality ) const
 {
     // TODO: Cache
+    static const option_handle<float> player_healing_rate( "PLAYER_HEALING_RATE" );
+    static const option_handle<float> npc_healing_rate( "NPC_HEALING_RATE" );
     float heal_rate;
     if( !is_npc() ) {
-        heal_rate = get_option< float >( "PLAYER_HEALING_RATE" );
+        heal_rate = player_healing_rate.value();
     } else {
-        heal_rate = get_option< float >( "NPC_HEALING_RATE" );
+        heal_rate = npc_healing_rate.value();
     }
     float awake_rate = heal_rate * mutation_value( "healing_awake" );
     float final_rate = 0.0f;
@@ -8671,9 +8684,9 @@ int Character::get_stamina() const
 
 int Character::get_stamina_max() const
 {
-    static const std::string player_max_stamina( "PLAYER_MAX_STAMINA" );
+    static const option_handle<int> player_max_stamina( "PLAYER_MAX_STAMINA" );
     static const std::string max_stamina_modifier( "max_stamina_modifier" );
-    int maxStamina = get_option< int >( player_max_stamina );
+    int maxStamina = player_max_stamina.value();
     maxStamina *= Character::mutation_value( max_stamina_modifier );
     maxStamina = enchantment_cache->modify_value( enchant_vals::mod::MAX_STAMINA, maxStamina );
     return maxStamina;
@@ -8707,7 +8720,9 @@ void Character::burn_move_stamina( int moves )
         overburden_percentage = ( current_weight - max_weight ) * 100 / max_weight;
     }
 
-    int burn_ratio = get_option<int>( "PLAYER_BASE_STAMINA_BURN_RATE" );
+    static const option_handle<int> player_base_stamina_burn_rate(
+        "PLAYER_BASE_STAMINA_BURN_RATE" );
+    int burn_ratio = player_base_stamina_burn_rate.value();
     for( const bionic_id &bid : get_bionic_fueled_with( item( "muscle" ) ) ) {
         if( has_active_bionic( bid ) ) {
             burn_ratio = burn_ratio * 2 - 3;
@@ -8739,9 +8754,10 @@ float Character::stamina_move_cost_modifier() const
 
 void Character::update_stamina( int turns )
 {
-    static const std::string player_base_stamina_regen_rate( "PLAYER_BASE_STAMINA_REGEN_RATE" );
+    static const option_handle<float> player_base_stamina_regen_rate(
+        "PLAYER_BASE_STAMINA_REGEN_RATE" );
     static const std::string stamina_regen_modifier( "stamina_regen_modifier" );
-    const float base_regen_rate = get_option<float>( player_base_stamina_regen_rate );
+    const float base_regen_rate = player_base_stamina_regen_rate.value();
     const int current_stim = get_stim();
     float stamina_recovery = 0.0f;
     // Recover some stamina every turn.
@@ -0,0 +1,136 @@
+#include "compression.h"
+
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <zlib.h>
+
+// 15 bits of window, + 16 for the gzip header instead of the zlib one
+static constexpr int gzip_window_bits = 15 + 16;
+// Saving happens while the game waits, and already the fastest level shrinks JSON about
+// tenfold, which is most of what slower levels get.
+static constexpr int compression_level = Z_BEST_SPEED;
+
+static const std::string gzip_magic( "\x1f\x8b", 2 );
+
+bool is_compressed_data( const std::string &data )
+{
+    return data.compare( 0, gzip_magic.size(), gzip_magic ) == 0;
+}
+
+static std::runtime_error zlib_error( const char *what, const z_stream &stream, const int ret )
+{
+    return std::runtime_error( std::string( what ) + " failed: " +
+                               ( stream.msg ? stream.msg : std::to_string( ret ) ) );
+}
+
+struct deflate_streambuf::z_state {
+    z_stream stream{};
+};
+
+deflate_streambuf::deflate_streambuf( std::ostream &out ) : out( out ),
+    z( std::make_unique<z_state>() )
+{
+    const int ret = deflateInit2( &z->stream, compression_level, Z_DEFLATED, gzip_window_bits, 8,
+                                  Z_DEFAULT_STRATEGY );
+    if( ret != Z_OK ) {
+        throw zlib_error( "deflateInit", z->stream, ret );
+    }
+    setp( buffer.data(), buffer.data() + buffer.size() );
+}
+
+deflate_streambuf::~deflate_streambuf()
+{
+    deflateEnd( &z->stream );
+}
+
+void deflate_streambuf::deflate_buffer( const int flush )
+{
+    std::array<char, 1 << 16> compressed;
+    z->stream.next_in = reinterpret_cast<Bytef *>( pbase() );
+    z->stream.avail_in = static_cast<uInt>( pptr() - pbase() );
+    int ret = Z_OK;
+    do {
+        z->stream.next_out = reinterpret_cast<Bytef *>( compressed.data() );
+        z->stream.avail_out = static_cast<uInt>( compressed.size() );
+        ret = deflate( &z->stream, flush );
+        if( ret == Z_STREAM_ERROR ) {
+            throw zlib_error( "deflate", z->stream, ret );
+        }
+        out.write( compressed.data(), compressed.size() - z->stream.avail_out );
+        // With Z_FINISH zlib may need several rounds of output space even without input left
+    } while( z->stream.avail_out == 0 || ( flush == Z_FINISH && ret != Z_STREAM_END ) );
+    setp( buffer.data(), buffer.data() + buffer.size() );
+    if( !out ) {
+        throw std::runtime_error( "writing compressed data failed" );
+    }
+}
+
+deflate_streambuf::int_type deflate_streambuf::overflow( const int_type c )
+{
+    try {
+        deflate_buffer( Z_NO_FLUSH );
+    } catch( const std::exception & ) {
+        failed = true;
+        return traits_type::eof();
+    }
+    if( !traits_type::eq_int_type( c, traits_type::eof() ) ) {
+        *pptr() = traits_type::to_char_type( c );
+        pbump( 1 );
+    }
+    return traits_type::not_eof( c );
+}
+
+int deflate_streambuf::sync()
+{
+    // Flushing the compressor would make the output worse, the data is written by finish()
+    return failed ? -1 : 0;
+}
+
+void deflate_streambuf::finish()
+{
+    if( failed ) {
+        throw std::runtime_error( "writing compressed data failed" );
+    }
+    deflate_buffer( Z_FINISH );
+}
+
+std::string compress_data( const std::string &data )
+{
+    std::ostringstream result;
+    deflate_streambuf buf( result );
+    std::ostream( &buf ).write( data.data(), data.size() );
+    buf.finish();
+    return result.str();
+}
+
+std::string decompress_data( const std::string &data )
+{
+    z_stream stream{};
+    int ret = inflateInit2( &stream, gzip_window_bits );
+    if( ret != Z_OK ) {
+        throw zlib_error( "inflateInit", stream, ret );
+    }
+    // Bytef is not const in older zlib versions, it is never written to though
+    stream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( data.data() ) );
+    stream.avail_in = static_cast<uInt>( data.size() );
+    std::string result;
+    std::array<char, 1 << 16> chunk;
+    do {
+        stream.next_out = reinterpret_cast<Bytef *>( chunk.data() );
+        stream.avail_out = static_cast<uInt>( chunk.size() );
+        ret = inflate( &stream, Z_NO_FLUSH );
+        if( ret != Z_OK && ret != Z_STREAM_END ) {
+            const std::runtime_error err = zlib_error( "inflate", stream, ret );
+            inflateEnd( &stream );
+            throw err;
+        }
+        result.append( chunk.data(), chunk.size() - stream.avail_out );
+    } while( ret != Z_STREAM_END && ( stream.avail_in != 0 || stream.avail_out == 0 ) );
+    inflateEnd( &stream );
+    if( ret != Z_STREAM_END ) {
+        throw std::runtime_error( "compressed data is truncated" );
+    }
+    return result;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef CATA_SRC_COMPRESSION_H
+#define CATA_SRC_COMPRESSION_H
+
+#include <array>
+#include <iosfwd>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+/**
+ * Compression of save files. Compressed data is in the gzip format, so it can be told apart
+ * from the JSON (and the binary map data) of uncompressed files by its first bytes, and it
+ * can be inspected with the usual tools.
+ *
+ * All functions throw std::runtime_error if zlib fails or if the data is malformed.
+ */
+enum class file_compression : int {
+    none,
+    deflate,
+};
+
+/** Whether @p data (the start of a file is enough) is compressed. */
+bool is_compressed_data( const std::string &data );
+
+std::string compress_data( const std::string &data );
+std::string decompress_data( const std::string &data );
+
+/**
+ * Compresses everything written to it and passes it on to another stream.
+ * @ref finish must be called after the last write, it throws if anything went wrong.
+ */
+class deflate_streambuf : public std::streambuf
+{
+    public:
+        explicit deflate_streambuf( std::ostream &out );
+        ~deflate_streambuf() override;
+
+        void finish();
+
+    protected:
+        int_type overflow( int_type c ) override;
+        int sync() override;
+
+    private:
+        struct z_state;
+
+        // Compresses the buffered data and writes out what zlib produced
+        void deflate_buffer( int flush );
+
+        std::ostream &out;
+        std::unique_ptr<z_state> z;
+        std::array<char, 1 << 16> buffer;
+        bool failed = false;
+};
+
+#endif // CATA_SRC_COMPRESSION_H
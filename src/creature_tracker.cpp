@@ -6,6 +6,8 @@
 
 #include "cata_assert.h"
 #include "debug.h"
+#include "game_constants.h"
+#include "line.h"
 #include "mongroup.h"
 #include "monster.h"
 #include "mtype.h"
@@ -14,6 +16,12 @@
 
 #define dbg(x) DebugLog((x),D_GAME) << __FILE__ << ":" << __LINE__ << ": "
 
+// Size of the (square) cells of the location index
+static constexpr int location_cell_size = 8;
+static constexpr int location_cells_x = ( MAPSIZE_X + location_cell_size - 1 ) / location_cell_size;
+static constexpr int location_cells_y = ( MAPSIZE_Y + location_cell_size - 1 ) / location_cell_size;
+static constexpr int location_cells_per_level = location_cells_x * location_cells_y;
+
 Creature_tracker::Creature_tracker() = default;
 
 Creature_tracker::~Creature_tracker() = default;
@@ -84,7 +92,7 @@ bool Creature_tracker::add( const shared_ptr_fast<monster> &critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos()] = critter_ptr;
+    set_location( critter.pos(), critter_ptr );
     add_to_faction_map( critter_ptr );
     return true;
 }
@@ -134,8 +142,8 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( critter.pos() );
-        monsters_by_location[new_pos] = *iter;
+        erase_location( critter.pos() );
+        set_location( new_pos, *iter );
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -154,7 +162,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( pos_iter->first );
         return;
     }
 
@@ -165,7 +173,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( iter->first );
     }
 }
 
@@ -198,17 +206,17 @@ void Creature_tracker::remove( const monster &critter )
 void Creature_tracker::clear()
 {
     monsters_list.clear();
-    monsters_by_location.clear();
+    clear_locations();
     monster_faction_map_.clear();
     removed_.clear();
 }
 
 void Creature_tracker::rebuild_cache()
 {
-    monsters_by_location.clear();
+    clear_locations();
     monster_faction_map_.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        set_location( mon_ptr->pos(), mon_ptr );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -227,13 +235,13 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_location( first_iter->first );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_location( second_iter->first );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -243,10 +251,10 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos()] = first_ptr;
+        set_location( first.pos(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos()] = second_ptr;
+        set_location( second.pos(), second_ptr );
     }
 }
 
@@ -289,3 +297,112 @@ void Creature_tracker::remove_dead()
 
     removed_.clear();
 }
+
+std::vector<monster *> &Creature_tracker::location_cell( const tripoint &pos )
+{
+    if( pos.x < 0 || pos.x >= MAPSIZE_X || pos.y < 0 || pos.y >= MAPSIZE_Y ||
+        pos.z < -OVERMAP_DEPTH || pos.z > OVERMAP_HEIGHT ) {
+        return out_of_bounds_monsters;
+    }
+    if( location_cells.empty() ) {
+        location_cells.resize( static_cast<size_t>( location_cells_per_level ) * OVERMAP_LAYERS );
+        monsters_on_level.assign( OVERMAP_LAYERS, 0 );
+    }
+    const int level = pos.z + OVERMAP_DEPTH;
+    const int cell = pos.y / location_cell_size * location_cells_x + pos.x / location_cell_size;
+    return location_cells[level * location_cells_per_level + cell];
+}
+
+void Creature_tracker::set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter )
+{
+    shared_ptr_fast<monster> &entry = monsters_by_location[pos];
+    if( entry == critter ) {
+        return;
+    }
+    std::vector<monster *> &cell = location_cell( pos );
+    if( entry ) {
+        // Replacing a (dead) monster that is still in the map
+        cell.erase( std::find( cell.begin(), cell.end(), entry.get() ) );
+    } else if( &cell != &out_of_bounds_monsters ) {
+        ++monsters_on_level[pos.z + OVERMAP_DEPTH];
+    }
+    entry = critter;
+    cell.push_back( critter.get() );
+}
+
+void Creature_tracker::erase_location( const tripoint pos )
+{
+    const auto iter = monsters_by_location.find( pos );
+    if( iter == monsters_by_location.end() ) {
+        return;
+    }
+    std::vector<monster *> &cell = location_cell( pos );
+    if( &cell != &out_of_bounds_monsters ) {
+        --monsters_on_level[pos.z + OVERMAP_DEPTH];
+    }
+    const auto cell_iter = std::find( cell.begin(), cell.end(), iter->second.get() );
+    cata_assert( cell_iter != cell.end() );
+    // Order within a cell does not matter
+    *cell_iter = cell.back();
+    cell.pop_back();
+    monsters_by_location.erase( iter );
+}
+
+void Creature_tracker::clear_locations()
+{
+    monsters_by_location.clear();
+    location_cells.clear();
+    out_of_bounds_monsters.clear();
+    monsters_on_level.clear();
+}
+
+std::vector<monster *> Creature_tracker::find_in_rectangle( const tripoint &min,
+        const tripoint &max ) const
+{
+    std::vector<monster *> result;
+    const auto add_if_inside = [&]( monster * critter ) {
+        const tripoint &p = critter->pos();
+        if( p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y &&
+            p.z >= min.z && p.z <= max.z && !critter->is_dead() ) {
+            result.push_back( critter );
+        }
+    };
+    for( monster *critter : out_of_bounds_monsters ) {
+        add_if_inside( critter );
+    }
+    if( location_cells.empty() || max.x < 0 || max.y < 0 || min.x >= MAPSIZE_X ||
+        min.y >= MAPSIZE_Y ) {
+        return result;
+    }
+    const int min_cx = std::max( min.x, 0 ) / location_cell_size;
+    const int min_cy = std::max( min.y, 0 ) / location_cell_size;
+    const int max_cx = std::min( max.x, MAPSIZE_X - 1 ) / location_cell_size;
+    const int max_cy = std::min( max.y, MAPSIZE_Y - 1 ) / location_cell_size;
+    for( int z = std::max( min.z, -OVERMAP_DEPTH ); z <= std::min( max.z, OVERMAP_HEIGHT ); ++z ) {
+        const int level = z + OVERMAP_DEPTH;
+        if( monsters_on_level[level] == 0 ) {
+            continue;
+        }
+        for( int cy = min_cy; cy <= max_cy; ++cy ) {
+            for( int cx = min_cx; cx <= max_cx; ++cx ) {
+                const std::vector<monster *> &cell =
+                    location_cells[level * location_cells_per_level + cy * location_cells_x + cx];
+                for( monster *critter : cell ) {
+                    add_if_inside( critter );
+                }
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<monster *> Creature_tracker::find_in_radius( const tripoint &center,
+        const int radius ) const
+{
+    std::vector<monster *> result = find_in_rectangle( center - tripoint( radius, radius, radius ),
+                                    center + tripoint( radius, radius, radius ) );
+    result.erase( std::remove_if( result.begin(), result.end(), [&]( const monster * critter ) {
+        return rl_dist( center, critter->pos() ) > radius;
+    } ), result.end() );
+    return result;
+}
@@ -92,11 +92,41 @@ class Creature_tracker
             return monster_faction_map_;
         }
 
+        /**
+         * Returns the living monsters inside the box spanned by the given corners (inclusive,
+         * including the z-levels between them), in no particular order.
+         * This only looks at the nearby buckets of the position index, so it is much cheaper
+         * than going through all monsters when the box is small.
+         */
+        std::vector<monster *> find_in_rectangle( const tripoint &min, const tripoint &max ) const;
+        /**
+         * Returns the living monsters within @p radius of @p center (as per @ref rl_dist),
+         * in no particular order.
+         */
+        std::vector<monster *> find_in_radius( const tripoint &center, int radius ) const;
+
     private:
         std::vector<shared_ptr_fast<monster>> monsters_list;
         std::unordered_map<tripoint, shared_ptr_fast<monster>> monsters_by_location;
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+
+        /**
+         * The monsters of @ref monsters_by_location bucketed by their location. Every z-level
+         * of the reality bubble is split into square cells, monsters outside of it are kept
+         * in a separate list. Only changed through the functions below, which keep it in sync
+         * with @ref monsters_by_location.
+         */
+        std::vector<std::vector<monster *>> location_cells;
+        std::vector<monster *> out_of_bounds_monsters;
+        /** Number of monsters in @ref location_cells per z-level, to skip empty levels. */
+        std::vector<int> monsters_on_level;
+
+        std::vector<monster *> &location_cell( const tripoint &pos );
+        void set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter );
+        // By value, as callers often pass the key of the entry that gets erased
+        void erase_location( tripoint pos );
+        void clear_locations();
 };
 
 #endif // CATA_SRC_CREATURE_TRACKER_H
@@ -0,0 +1,141 @@
+#include "data_cache.h"
+
+#include <algorithm>
+#include <exception>
+#include <istream>
+#include <ostream>
+
+#include "cata_utility.h"
+#include "debug.h"
+#include "filesystem.h"
+#include "get_version.h"
+#include "optional.h"
+#include "options.h"
+#include "path_info.h"
+
+// How many keys of checked data are kept, enough for switching between a few mod sets
+static constexpr size_t max_checked_keys = 16;
+
+static cata::optional<data_cache::cache_mode> mode_override;
+static std::string directory_override;
+
+static constexpr uint64_t hash_start = 0xcbf29ce484222325ULL;
+
+// FNV-1a, which is stable across builds and platforms unlike std::hash
+static uint64_t hash_bytes( uint64_t hash, const std::string &bytes )
+{
+    for( const char c : bytes ) {
+        hash ^= static_cast<uint8_t>( c );
+        hash *= 0x100000001b3ULL;
+    }
+    // Separator, so "ab" + "c" differs from "a" + "bc"
+    hash ^= 0xFF;
+    hash *= 0x100000001b3ULL;
+    return hash;
+}
+
+static std::string cache_dir()
+{
+    return directory_override.empty() ? PATH_INFO::data_cache_dir() : directory_override;
+}
+
+static std::string checked_file()
+{
+    return cache_dir() + "checked";
+}
+
+// Oldest first
+static std::vector<uint64_t> read_checked_keys()
+{
+    std::vector<uint64_t> keys;
+    read_from_file_optional( checked_file(), [&keys]( std::istream & fin ) {
+        uint64_t key = 0;
+        while( fin >> key ) {
+            keys.push_back( key );
+        }
+    } );
+    return keys;
+}
+
+static void write_checked_keys( const std::vector<uint64_t> &keys )
+{
+    if( !assure_dir_exist( cache_dir() ) ) {
+        return;
+    }
+    try {
+        write_to_file( checked_file(), [&keys]( std::ostream & fout ) {
+            for( const uint64_t key : keys ) {
+                fout << key << '\n';
+            }
+        } );
+    } catch( const std::exception &err ) {
+        DebugLog( D_WARNING, DC_ALL ) << "failed to write the data cache: " << err.what();
+    }
+}
+
+namespace data_cache
+{
+
+cache_mode mode()
+{
+    if( mode_override ) {
+        return *mode_override;
+    }
+    return get_option<bool>( "DATA_CACHE" ) ? cache_mode::enabled : cache_mode::disabled;
+}
+
+void set_mode( cache_mode mode )
+{
+    mode_override = mode;
+}
+
+void set_directory( const std::string &dir )
+{
+    directory_override = dir;
+}
+
+uint64_t content_hash( const std::string &contents )
+{
+    return hash_bytes( hash_start, contents );
+}
+
+uint64_t files_key( const std::vector<std::string> &files, const std::vector<uint64_t> &hashes )
+{
+    uint64_t key = hash_bytes( hash_start, getVersionString() );
+    for( size_t i = 0; i < files.size(); ++i ) {
+        key = hash_bytes( key, files[i] );
+        key = hash_bytes( key, std::to_string( hashes[i] ) );
+    }
+    return key;
+}
+
+uint64_t combine_keys( uint64_t key, uint64_t other )
+{
+    return hash_bytes( key, std::to_string( other ) );
+}
+
+bool was_checked( uint64_t key )
+{
+    const std::vector<uint64_t> keys = read_checked_keys();
+    return std::find( keys.begin(), keys.end(), key ) != keys.end();
+}
+
+void set_checked( uint64_t key )
+{
+    std::vector<uint64_t> keys = read_checked_keys();
+    keys.erase( std::remove( keys.begin(), keys.end(), key ), keys.end() );
+    keys.push_back( key );
+    if( keys.size() > max_checked_keys ) {
+        keys.erase( keys.begin(), keys.end() - max_checked_keys );
+    }
+    write_checked_keys( keys );
+}
+
+void clear_checked()
+{
+    if( file_exist( checked_file() ) ) {
+        remove_file( checked_file() );
+    }
+}
+
+} // namespace data_cache
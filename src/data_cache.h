@@ -0,0 +1,56 @@
+#pragma once
+#ifndef CATA_SRC_DATA_CACHE_H
+#define CATA_SRC_DATA_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Cache in the user directory of which game data passed the consistency checks, so that
+ * starting the game does not repeat the checks of data that passed them before.  It is opt-in
+ * and only skips the checks: the data is still loaded and finalized every time, there is no
+ * snapshot of the loaded data.
+ *
+ * Every loaded data path gets a key, a hash of the game version and of the names and
+ * contents of its files. The keys of all loaded paths are combined in load order, and the
+ * combined key is recorded once the data passed the checks. Only the most recently checked
+ * keys are kept.
+ *
+ * Reading and writing the cache never throws, a broken cache is just rebuilt.
+ */
+namespace data_cache
+{
+
+enum class cache_mode : int {
+    disabled,
+    // Use the cache when it is valid and update it otherwise
+    enabled,
+    // Forget what the cache recorded, check the data and record it again
+    rebuild,
+    // Check the data anyway and report if the cache recorded data that fails the checks
+    verify,
+};
+
+/** Mode given on the command line, otherwise taken from the DATA_CACHE option. */
+cache_mode mode();
+void set_mode( cache_mode mode );
+/** Keeps the cache in @p dir instead of PATH_INFO::data_cache_dir, if it is not empty. */
+void set_directory( const std::string &dir );
+
+/** Hash of the contents of a data file, the same on all builds and platforms. */
+uint64_t content_hash( const std::string &contents );
+/** Key of a data path from the current version, its @p files and their content @p hashes. */
+uint64_t files_key( const std::vector<std::string> &files, const std::vector<uint64_t> &hashes );
+/** Combines the keys of several data paths, in load order. */
+uint64_t combine_keys( uint64_t key, uint64_t other );
+
+/** Whether the data with the combined @p key passed the consistency checks before. */
+bool was_checked( uint64_t key );
+void set_checked( uint64_t key );
+/** Forgets all data that passed the checks. */
+void clear_checked();
+
+} // namespace data_cache
+
+#endif // CATA_SRC_DATA_CACHE_H
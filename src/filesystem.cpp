@@ -26,6 +26,7 @@
 #   include "wdirent.h"
 #else
 #   include <dirent.h>
+#   include <fcntl.h>
 #   include <unistd.h>
 #endif
 
@@ -107,6 +108,31 @@ bool rename_file( const std::string &old_path, const std::string &new_path )
 }
 #endif
 
+#if defined(_WIN32)
+bool sync_file( const std::string &path )
+{
+    const HANDLE file = CreateFile( path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+    if( file == INVALID_HANDLE_VALUE ) {
+        return false;
+    }
+    const bool synced = FlushFileBuffers( file ) != 0;
+    CloseHandle( file );
+    return synced;
+}
+#else
+bool sync_file( const std::string &path )
+{
+    const int fd = open( path.c_str(), O_WRONLY );
+    if( fd < 0 ) {
+        return false;
+    }
+    const bool synced = fsync( fd ) == 0;
+    close( fd );
+    return synced;
+}
+#endif
+
 bool remove_directory( const std::string &path )
 {
 #if defined(_WIN32)
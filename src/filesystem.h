@@ -14,6 +14,9 @@ bool remove_file( const std::string &path );
 bool remove_directory( const std::string &path );
 // Rename a file, overriding the target!
 bool rename_file( const std::string &old_path, const std::string &new_path );
+// Make sure what was written to a file is on the disk, not only in the caches of the OS,
+// returns true on success
+bool sync_file( const std::string &path );
 
 std::string read_entire_file( const std::string &path );
 
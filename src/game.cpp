@@ -55,6 +55,7 @@
 #include "clzones.h"
 #include "colony.h"
 #include "color.h"
+#include "compression.h"
 #include "computer_session.h"
 #include "construction.h"
 #include "construction_group.h"
@@ -161,6 +162,7 @@
 #include "timed_event.h"
 #include "translations.h"
 #include "trap.h"
+#include "turn_profiler.h"
 #include "ui.h"
 #include "ui_manager.h"
 #include "uistate.h"
@@ -1451,6 +1453,9 @@ bool game::do_turn()
     // starting a new turn, clear out temperature cache
     weather.temperature_cache.clear();
 
+    // The map files of the last save are written in the background
+    MAPBUFFER.report_finished_save();
+
     if( npcs_dirty ) {
         load_npcs();
     }
@@ -1485,8 +1490,10 @@ bool game::do_turn()
     u.update_body();
 
     // Auto-save if autosave is enabled
-    if( get_option<bool>( "AUTOSAVE" ) &&
-        calendar::once_every( 1_turns * get_option<int>( "AUTOSAVE_TURNS" ) ) &&
+    static const option_handle<bool> autosave_enabled( "AUTOSAVE" );
+    static const option_handle<int> autosave_turns( "AUTOSAVE_TURNS" );
+    if( autosave_enabled.value() &&
+        calendar::once_every( 1_turns * autosave_turns.value() ) &&
         !u.is_dead_state() ) {
         autosave();
     }
@@ -1591,25 +1598,49 @@ bool game::do_turn()
         scent.set( u.pos(), u.scent, u.get_type_of_scent() );
         overmap_buffer.set_scent( u.global_omt_location(),  u.scent );
     }
-    scent.update( u.pos(), m );
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::scent_update );
+        scent.update( u.pos(), m );
+    }
 
     // We need floor cache before checking falling 'n stuff
-    m.build_floor_caches();
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::build_floor_caches );
+        m.build_floor_caches();
+    }
 
     m.process_falling();
-    m.vehmove();
-    m.process_fields();
-    m.process_items();
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::vehmove );
+        m.vehmove();
+    }
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::process_fields );
+        m.process_fields();
+    }
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::process_items );
+        m.process_items();
+    }
     explosion_handler::process_explosions();
     m.creature_in_field( u );
 
     // Apply sounds from previous turn to monster and NPC AI.
-    sounds::process_sounds();
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::process_sounds );
+        sounds::process_sounds();
+    }
     const int levz = m.get_abs_sub().z;
     // Update vision caches for monsters. If this turns out to be expensive,
     // consider a stripped down cache just for monsters.
-    m.build_map_cache( levz, true );
-    monmove();
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::build_map_cache );
+        m.build_map_cache( levz, true );
+    }
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::monmove );
+        monmove();
+    }
     if( calendar::once_every( 5_minutes ) ) {
         overmap_npc_move();
     }
@@ -1630,7 +1661,8 @@ bool game::do_turn()
     update_stair_monsters();
     mon_info_update();
     u.process_turn();
-    if( u.moves < 0 && get_option<bool>( "FORCE_REDRAW" ) ) {
+    static const option_handle<bool> force_redraw( "FORCE_REDRAW" );
+    if( u.moves < 0 && force_redraw.value() ) {
         ui_manager::redraw();
         refresh_display();
     }
@@ -1676,7 +1708,10 @@ bool game::do_turn()
         first_redraw_since_waiting_started = true;
     }
 
-    u.update_bodytemp();
+    {
+        turn_profiler::scoped_phase timer( turn_profiler::phase::update_bodytemp );
+        u.update_bodytemp();
+    }
     u.update_body_wetness( *weather.weather_precise );
     u.apply_wetness_morale( weather.temperature );
 
@@ -1699,6 +1734,8 @@ bool game::do_turn()
     // reset player noise
     u.volume = 0;
 
+    turn_profiler::end_turn();
+
     return false;
 }
 
@@ -3137,7 +3174,7 @@ bool game::save_factions_missions_npcs()
     std::string masterfile = PATH_INFO::world_base_save_path() + "/" + SAVE_MASTER;
     return write_to_file( masterfile, [&]( std::ostream & fout ) {
         serialize_master( fout );
-    }, _( "factions data" ) );
+    }, _( "factions data" ), save_file_compression() );
 }
 
 bool game::save_maps()
@@ -3159,7 +3196,7 @@ bool game::save_player_data()
 
     const bool saved_data = write_to_file( playerfile + SAVE_EXTENSION, [&]( std::ostream & fout ) {
         serialize( fout );
-    }, _( "player data" ) );
+    }, _( "player data" ), save_file_compression() );
     const bool saved_map_memory = u.save_map_memory();
     const bool saved_log = write_to_file( playerfile + SAVE_EXTENSION_LOG, [&](
     std::ostream & fout ) {
@@ -3664,8 +3701,10 @@ void game::draw_panels( bool force_draw )
     const bool draw_this_turn = current_turn > previous_turn || force_draw;
     auto &mgr = panel_manager::get_manager();
     int y = 0;
-    const bool sidebar_right = get_option<std::string>( "SIDEBAR_POSITION" ) == "right";
-    int spacer = get_option<bool>( "SIDEBAR_SPACERS" ) ? 1 : 0;
+    static const option_handle<std::string> sidebar_position( "SIDEBAR_POSITION" );
+    static const option_handle<bool> sidebar_spacers( "SIDEBAR_SPACERS" );
+    const bool sidebar_right = sidebar_position.value() == "right";
+    int spacer = sidebar_spacers.value() ? 1 : 0;
     int log_height = 0;
     for( const window_panel &panel : mgr.get_current_layout().panels() ) {
         if( panel.get_height() != -2 && panel.toggle && panel.render() ) {
@@ -3795,7 +3834,8 @@ void game::draw_ter( const tripoint &center, const bool looking, const bool draw
 
 cata::optional<tripoint> game::get_veh_dir_indicator_location( bool next ) const
 {
-    if( !get_option<bool>( "VEHICLE_DIR_INDICATOR" ) ) {
+    static const option_handle<bool> vehicle_dir_indicator( "VEHICLE_DIR_INDICATOR" );
+    if( !vehicle_dir_indicator.value() ) {
         return cata::nullopt;
     }
     const optional_vpart_position vp = m.veh_at( u.pos() );
@@ -4371,8 +4411,12 @@ void game::mon_info( const catacurses::window &w, int hor_padding )
 
 void game::mon_info_update( )
 {
+    static const option_handle<int> safemode_proximity( "SAFEMODEPROXIMITY" );
+    static const option_handle<int> safemode_ignore_turns( "SAFEMODEIGNORETURNS" );
+    static const option_handle<bool> autosafemode( "AUTOSAFEMODE" );
+    static const option_handle<int> autosafemode_turns( "AUTOSAFEMODETURNS" );
     int newseen = 0;
-    const int safe_proxy_dist = get_option<int>( "SAFEMODEPROXIMITY" );
+    const int safe_proxy_dist = safemode_proximity.value();
     const int iProxyDist = ( safe_proxy_dist <= 0 ) ? MAX_VIEW_DISTANCE :
                            safe_proxy_dist;
 
@@ -4398,7 +4442,7 @@ void game::mon_info_update( )
 
     static time_point previous_turn = calendar::turn_zero;
     const time_duration sm_ignored_turns =
-        time_duration::from_turns( get_option<int>( "SAFEMODEIGNORETURNS" ) );
+        time_duration::from_turns( safemode_ignore_turns.value() );
 
     for( Creature *c : u.get_visible_creatures( MAPSIZE_X ) ) {
         monster *m = dynamic_cast<monster *>( c );
@@ -4560,11 +4604,11 @@ void game::mon_info_update( )
         if( safe_mode == SAFE_MODE_ON ) {
             set_safe_mode( SAFE_MODE_STOP );
         }
-    } else if( calendar::turn > previous_turn && get_option<bool>( "AUTOSAFEMODE" ) &&
+    } else if( calendar::turn > previous_turn && autosafemode.value() &&
                newseen == 0 ) { // Auto-safe mode, but only if it's a new turn
         turnssincelastmon += calendar::turn - previous_turn;
         time_duration auto_safe_mode =
-            time_duration::from_turns( get_option<int>( "AUTOSAFEMODETURNS" ) );
+            time_duration::from_turns( autosafemode_turns.value() );
         if( turnssincelastmon >= auto_safe_mode && safe_mode == SAFE_MODE_OFF ) {
             set_safe_mode( SAFE_MODE_ON );
             add_msg( m_info, _( "Safe mode ON!" ) );
@@ -11649,6 +11693,33 @@ point game::update_map( Character &p )
     return update_map( p2.x, p2.y );
 }
 
+// Reads the submaps the avatar is heading towards in advance, see map::prefetch_ahead
+static void prefetch_submaps_ahead( map &here, Character &you, const point &last_shift )
+{
+    // Without a better guess, keep going the way the map was just shifted
+    point direction( sgn( last_shift.x ), sgn( last_shift.y ) );
+    int distance = 1;
+    const optional_vpart_position vp = here.veh_at( you.pos() );
+    if( you.in_vehicle && vp && vp->vehicle().velocity != 0 ) {
+        const vehicle &veh = vp->vehicle();
+        const units::angle dir = veh.velocity > 0 ? veh.move.dir() : veh.move.dir() + 180_degrees;
+        // Only go diagonal if the heading is closer to the diagonal than to an axis
+        const auto component = []( const double v ) {
+            return v > 0.38 ? 1 : v < -0.38 ? -1 : 0;
+        };
+        direction = point( component( units::cos( dir ) ), component( units::sin( dir ) ) );
+        // Fast vehicles cross several submaps per turn
+        const int tiles_per_turn = static_cast<int>( std::abs( veh.velocity ) /
+                                   vehicles::vmiph_per_tile );
+        distance = std::min( 1 + tiles_per_turn / SEEX, 4 );
+    } else if( you.has_destination() && !you.get_auto_move_route().empty() ) {
+        const std::vector<tripoint> &route = you.get_auto_move_route();
+        const tripoint &target = route[std::min<size_t>( route.size() - 1, SEEX )];
+        direction = point( sgn( target.x - you.posx() ), sgn( target.y - you.posy() ) );
+    }
+    here.prefetch_ahead( direction, distance );
+}
+
 point game::update_map( int &x, int &y )
 {
     point shift;
@@ -11739,6 +11810,8 @@ point game::update_map( int &x, int &y )
     // Update what parts of the world map we can see
     update_overmap_seen();
 
+    prefetch_submaps_ahead( m, u, shift );
+
     return shift;
 }
 
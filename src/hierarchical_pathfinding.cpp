@@ -0,0 +1,298 @@
+#include "hierarchical_pathfinding.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "cata_utility.h"
+#include "game_constants.h"
+#include "map.h"
+#include "mapdata.h"
+#include "pathfinding.h"
+
+static constexpr int cluster_tiles = SEEX * SEEY;
+
+// Cost of entering p in the rough cost model of the abstract graph, 0 if it can't be entered
+static int abstract_cost( const map &m, const pathfinding_cache &cache, const tripoint &p )
+{
+    const pf_special special = cache.special[p.x][p.y];
+    if( special & PF_WALL ) {
+        // Closed doors are walls too, but most pathfinders can open them
+        if( m.ter( p ).obj().open || m.furn( p ).obj().open ) {
+            return 6;
+        }
+        return 0;
+    }
+    return special & PF_SLOW ? 4 : 2;
+}
+
+int pathfinding_hierarchy::cluster_index( const point &p ) const
+{
+    return ( p.x / SEEX ) * clusters_per_side + p.y / SEEY;
+}
+
+std::vector<int> pathfinding_hierarchy::costs_within_cluster( const map &m, const point &p,
+        const int index ) const
+{
+    const cluster &c = clusters[index];
+    const point origin( ( index / clusters_per_side ) * SEEX, ( index % clusters_per_side ) * SEEY );
+    const pathfinding_cache &cache = m.get_pathfinding_cache_ref( zlev );
+    const auto local_index = [&origin]( const point & pos ) {
+        return ( pos.x - origin.x ) * SEEY + ( pos.y - origin.y );
+    };
+
+    std::array<int, cluster_tiles> dist;
+    dist.fill( -1 );
+    std::priority_queue<std::pair<int, point>, std::vector<std::pair<int, point>>, pair_greater_cmp_first>
+    open;
+    dist[local_index( p )] = 0;
+    open.emplace( 0, p );
+    while( !open.empty() ) {
+        const std::pair<int, point> cur = open.top();
+        open.pop();
+        if( cur.first > dist[local_index( cur.second )] ) {
+            continue;
+        }
+        for( const tripoint &neighbor : eight_horizontal_neighbors ) {
+            const point offset = neighbor.xy();
+            const point next = cur.second + offset;
+            if( next.x < origin.x || next.x >= origin.x + SEEX ||
+                next.y < origin.y || next.y >= origin.y + SEEY ) {
+                continue;
+            }
+            const int cost = abstract_cost( m, cache, tripoint( next, zlev ) );
+            if( cost == 0 ) {
+                continue;
+            }
+            const int next_dist = cur.first + cost + ( offset.x != 0 && offset.y != 0 ? 1 : 0 );
+            int &old_dist = dist[local_index( next )];
+            if( old_dist < 0 || next_dist < old_dist ) {
+                old_dist = next_dist;
+                open.emplace( next_dist, next );
+            }
+        }
+    }
+
+    std::vector<int> ret;
+    ret.reserve( c.nodes.size() );
+    for( const entrance &e : c.nodes ) {
+        ret.push_back( dist[local_index( e.pos )] );
+    }
+    return ret;
+}
+
+void pathfinding_hierarchy::rebuild_cluster( const map &m, const int index )
+{
+    cluster &c = clusters[index];
+    const point origin( ( index / clusters_per_side ) * SEEX, ( index % clusters_per_side ) * SEEY );
+    const pathfinding_cache &cache = m.get_pathfinding_cache_ref( zlev );
+    const int mapsize = clusters_per_side * SEEX;
+
+    c.nodes.clear();
+    // Walks one border of the cluster: `inside` runs along its edge, `across` points out of it
+    const auto add_border = [&]( const point & start, const point & along, const point & across ) {
+        const point outside_start = start + across;
+        if( outside_start.x < 0 || outside_start.x >= mapsize ||
+            outside_start.y < 0 || outside_start.y >= mapsize ) {
+            return;
+        }
+        int run_start = -1;
+        for( int i = 0; i <= SEEX; i++ ) {
+            const point inside = start + along * i;
+            const bool open = i < SEEX &&
+                              abstract_cost( m, cache, tripoint( inside, zlev ) ) > 0 &&
+                              abstract_cost( m, cache, tripoint( inside + across, zlev ) ) > 0;
+            if( open && run_start < 0 ) {
+                run_start = i;
+            } else if( !open && run_start >= 0 ) {
+                const point entry = start + along * ( ( run_start + i - 1 ) / 2 );
+                c.nodes.push_back( { entry, entry + across } );
+                run_start = -1;
+            }
+        }
+    };
+    add_border( origin, point_south, point_west );
+    add_border( origin + point( SEEX - 1, 0 ), point_south, point_east );
+    add_border( origin, point_east, point_north );
+    add_border( origin + point( 0, SEEY - 1 ), point_east, point_south );
+
+    const size_t num_nodes = c.nodes.size();
+    c.costs.assign( num_nodes * num_nodes, -1 );
+    for( size_t i = 0; i < num_nodes; i++ ) {
+        const std::vector<int> costs = costs_within_cluster( m, c.nodes[i].pos, index );
+        std::copy( costs.begin(), costs.end(), c.costs.begin() + i * num_nodes );
+    }
+    c.built = true;
+}
+
+void pathfinding_hierarchy::update( const map &m, const int z )
+{
+    const pathfinding_cache &cache = m.get_pathfinding_cache_ref( z );
+    const int per_side = m.getmapsize();
+    if( z == zlev && per_side == clusters_per_side && cache.generation == cache_generation ) {
+        return;
+    }
+    if( z != zlev || per_side != clusters_per_side ) {
+        zlev = z;
+        clusters_per_side = per_side;
+        clusters.assign( static_cast<size_t>( per_side * per_side ), cluster() );
+    }
+    const int built_generation = cache_generation;
+    cache_generation = cache.generation;
+
+    std::vector<bool> affected( clusters.size(), false );
+    std::vector<uint64_t> hashes( clusters.size() );
+    for( size_t index = 0; index < clusters.size(); index++ ) {
+        const int cx = index / per_side;
+        const int cy = index % per_side;
+        // Only the submaps that changed since the graph was built need to be hashed again
+        if( clusters[index].built &&
+            cache.submap_generation[cx * MAPSIZE + cy] <= built_generation ) {
+            hashes[index] = clusters[index].hash;
+            continue;
+        }
+        const point origin( cx * SEEX, cy * SEEY );
+        // FNV-1a over the costs the cluster was built from.  Hashing the cache alone would miss
+        // a wall turning into a closed door, as both are PF_WALL.
+        uint64_t hash = 14695981039346656037ULL;
+        for( int x = origin.x; x < origin.x + SEEX; x++ ) {
+            for( int y = origin.y; y < origin.y + SEEY; y++ ) {
+                const int cost = abstract_cost( m, cache, tripoint( x, y, z ) );
+                hash = ( hash ^ static_cast<uint64_t>( cost ) ) * 1099511628211ULL;
+            }
+        }
+        hashes[index] = hash;
+        if( clusters[index].built && clusters[index].hash == hash ) {
+            continue;
+        }
+        // Entrances are shared with the neighbors, so they need a rebuild too
+        affected[index] = true;
+        for( const point &offset : four_adjacent_offsets ) {
+            const point neighbor( cx + offset.x, cy + offset.y );
+            if( neighbor.x >= 0 && neighbor.x < per_side && neighbor.y >= 0 && neighbor.y < per_side ) {
+                affected[neighbor.x * per_side + neighbor.y] = true;
+            }
+        }
+    }
+
+    for( size_t index = 0; index < clusters.size(); index++ ) {
+        if( affected[index] ) {
+            clusters[index].hash = hashes[index];
+            rebuild_cluster( m, index );
+        }
+    }
+}
+
+std::vector<tripoint> pathfinding_hierarchy::plan( const map &m, const tripoint &f,
+        const tripoint &t ) const
+{
+    std::vector<tripoint> ret;
+    const int mapsize = clusters_per_side * SEEX;
+    if( f.z != zlev || t.z != zlev || clusters.empty() ||
+        f.x < 0 || f.x >= mapsize || f.y < 0 || f.y >= mapsize ||
+        t.x < 0 || t.x >= mapsize || t.y < 0 || t.y >= mapsize ) {
+        return ret;
+    }
+    const int start_cluster = cluster_index( f.xy() );
+    const int goal_cluster = cluster_index( t.xy() );
+    if( start_cluster == goal_cluster ) {
+        return ret;
+    }
+
+    // Nodes are numbered consecutively over all clusters, followed by the goal
+    std::vector<int> first_node( clusters.size() + 1, 0 );
+    for( size_t i = 0; i < clusters.size(); i++ ) {
+        first_node[i + 1] = first_node[i] + static_cast<int>( clusters[i].nodes.size() );
+    }
+    const int goal_node = first_node.back();
+    const std::vector<int> start_costs = costs_within_cluster( m, f.xy(), start_cluster );
+    const std::vector<int> goal_costs = costs_within_cluster( m, t.xy(), goal_cluster );
+
+    std::vector<int> gscore( goal_node + 1, -1 );
+    std::vector<int> parent( goal_node + 1, -1 );
+    std::vector<bool> closed( goal_node + 1, false );
+    std::vector<int> node_cluster( goal_node + 1, -1 );
+    for( size_t i = 0; i < clusters.size(); i++ ) {
+        std::fill( node_cluster.begin() + first_node[i], node_cluster.begin() + first_node[i + 1],
+                   static_cast<int>( i ) );
+    }
+    const auto node_pos = [&]( const int node ) {
+        return clusters[node_cluster[node]].nodes[node - first_node[node_cluster[node]]].pos;
+    };
+    const auto estimate = [&t]( const point & p ) {
+        return 2 * std::max( std::abs( p.x - t.x ), std::abs( p.y - t.y ) );
+    };
+
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, pair_greater_cmp_first>
+    open;
+    const auto relax = [&]( const int from, const int to, const int cost ) {
+        const int new_score = ( from < 0 ? 0 : gscore[from] ) + cost;
+        if( closed[to] || ( gscore[to] >= 0 && gscore[to] <= new_score ) ) {
+            return;
+        }
+        gscore[to] = new_score;
+        parent[to] = from;
+        open.emplace( new_score + ( to == goal_node ? 0 : estimate( node_pos( to ) ) ), to );
+    };
+
+    for( size_t i = 0; i < start_costs.size(); i++ ) {
+        if( start_costs[i] >= 0 ) {
+            relax( -1, first_node[start_cluster] + i, start_costs[i] );
+        }
+    }
+
+    bool found = false;
+    while( !open.empty() ) {
+        const int cur = open.top().second;
+        open.pop();
+        if( closed[cur] ) {
+            continue;
+        }
+        closed[cur] = true;
+        if( cur == goal_node ) {
+            found = true;
+            break;
+        }
+
+        const int cur_cluster = node_cluster[cur];
+        const cluster &c = clusters[cur_cluster];
+        const size_t local = cur - first_node[cur_cluster];
+        const size_t num_nodes = c.nodes.size();
+        for( size_t j = 0; j < num_nodes; j++ ) {
+            const int cost = c.costs[local * num_nodes + j];
+            if( j != local && cost >= 0 ) {
+                relax( cur, first_node[cur_cluster] + j, cost );
+            }
+        }
+        if( cur_cluster == goal_cluster && goal_costs[local] >= 0 ) {
+            relax( cur, goal_node, goal_costs[local] );
+        }
+
+        const point &partner = c.nodes[local].partner;
+        const int partner_cluster = cluster_index( partner );
+        const std::vector<entrance> &partner_nodes = clusters[partner_cluster].nodes;
+        for( size_t j = 0; j < partner_nodes.size(); j++ ) {
+            if( partner_nodes[j].pos == partner ) {
+                relax( cur, first_node[partner_cluster] + j, 2 );
+                break;
+            }
+        }
+    }
+
+    if( !found ) {
+        return ret;
+    }
+
+    ret.push_back( t );
+    for( int cur = parent[goal_node]; cur >= 0 && parent[cur] >= 0; cur = parent[cur] ) {
+        if( node_cluster[parent[cur]] != node_cluster[cur] ) {
+            // Entered a new cluster here
+            ret.emplace_back( node_pos( cur ), zlev );
+        }
+    }
+    std::reverse( ret.begin(), ret.end() );
+    return ret;
+}
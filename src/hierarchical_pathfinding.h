@@ -0,0 +1,71 @@
+#pragma once
+#ifndef CATA_SRC_HIERARCHICAL_PATHFINDING_H
+#define CATA_SRC_HIERARCHICAL_PATHFINDING_H
+
+#include <cstdint>
+#include <vector>
+
+#include "point.h"
+
+class map;
+
+/**
+ * Abstract graph over the submaps of a single z-level of the reality bubble, used to plan
+ * long routes cheaply (HPA*).
+ *
+ * Every submap is a cluster.  Where walkable tiles line up on both sides of the border
+ * between two clusters, the middle of each such run becomes an entrance, which is a node
+ * on each side linked across the border.  Within a cluster, the nodes are linked by the
+ * cost of the shortest path between them that doesn't leave the cluster.
+ *
+ * A route is planned on this graph and then refined into tiles by @ref map::route between
+ * consecutive waypoints, so the graph only needs a rough cost model: it knows about walls,
+ * slow terrain and doors, but not about bashing, traps or vehicles.
+ *
+ * The graph is derived from @ref pathfinding_cache.  Only the clusters of the submaps the cache
+ * reports as changed are hashed again, and only those whose tile costs changed (and their
+ * neighbors, whose entrances they share) are rebuilt.
+ */
+class pathfinding_hierarchy
+{
+    public:
+        /** Brings the graph up to date with the pathfinding cache of the z-level. */
+        void update( const map &m, int zlev );
+
+        /**
+         * Plans a route from f to t, which need to be on the z-level of the graph.
+         * @return Waypoints where the route enters a new cluster, followed by t.  Each waypoint
+         * is at most a cluster away from the previous one.  Empty if f and t are in the same
+         * cluster or no route was found.
+         */
+        std::vector<tripoint> plan( const map &m, const tripoint &f, const tripoint &t ) const;
+
+    private:
+        struct entrance {
+            // Position of the node, in map-local coordinates
+            point pos;
+            // Position of the linked node on the other side of the border
+            point partner;
+        };
+
+        struct cluster {
+            // Hash of the tile costs the cluster was built from
+            uint64_t hash = 0;
+            bool built = false;
+            std::vector<entrance> nodes;
+            // nodes.size() x nodes.size() matrix of costs between nodes, -1 if unreachable
+            std::vector<int> costs;
+        };
+
+        int zlev = 0;
+        int clusters_per_side = 0;
+        int cache_generation = -1;
+        std::vector<cluster> clusters;
+
+        int cluster_index( const point &p ) const;
+        void rebuild_cluster( const map &m, int index );
+        /** Costs from p to every node of its cluster, without leaving the cluster. */
+        std::vector<int> costs_within_cluster( const map &m, const point &p, int index ) const;
+};
+
+#endif // CATA_SRC_HIERARCHICAL_PATHFINDING_H
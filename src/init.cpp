@@ -1,9 +1,11 @@
 #include "init.h"
 
+#include <chrono>
 #include <cstddef>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <memory>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -19,6 +21,7 @@
 #include "bodypart.h"
 #include "butchery_requirements.h"
 #include "cata_assert.h"
+#include "cached_options.h"
 #include "cata_utility.h"
 #include "clothing_mod.h"
 #include "clzones.h"
@@ -27,6 +30,7 @@
 #include "construction_group.h"
 #include "crafting_gui.h"
 #include "creature.h"
+#include "data_cache.h"
 #include "debug.h"
 #include "dialogue.h"
 #include "disease.h"
@@ -89,6 +93,7 @@
 #include "start_location.h"
 #include "string_formatter.h"
 #include "text_snippets.h"
+#include "thread_pool.h"
 #include "translations.h"
 #include "trap.h"
 #include "type_id.h"
@@ -124,23 +129,18 @@ void DynamicDataLoader::load_object( const JsonObject &jo, const std::string &sr
 }
 
 struct DynamicDataLoader::cached_streams {
-    lru_cache<std::string, shared_ptr_fast<std::istringstream>> cache;
+    lru_cache<std::string, shared_ptr_fast<const std::string>> cache;
 };
 
-shared_ptr_fast<std::istream> DynamicDataLoader::get_cached_stream( const std::string &path )
+shared_ptr_fast<const std::string> DynamicDataLoader::get_cached_data( const std::string &path )
 {
     cata_assert( !finalized &&
                  "Cannot open data file after finalization." );
     cata_assert( stream_cache &&
                  "Stream cache is only available during finalization" );
-    shared_ptr_fast<std::istringstream> cached = stream_cache->cache.get( path, nullptr );
-    // Create a new stream if the file is not opened yet, or if some code is still
-    // using the previous stream (in such case, `cached` and `stream_cache` have
-    // two references to the stream, hence the test for > 2).
+    shared_ptr_fast<const std::string> cached = stream_cache->cache.get( path, nullptr );
     if( !cached ) {
-        cached = make_shared_fast<std::istringstream>( read_entire_file( path ) );
-    } else if( cached.use_count() > 2 ) {
-        cached = make_shared_fast<std::istringstream>( cached->str() );
+        cached = make_shared_fast<const std::string>( read_entire_file( path ) );
     }
     stream_cache->cache.insert( 8, path, cached );
     return cached;
@@ -156,8 +156,8 @@ void DynamicDataLoader::load_deferred( deferred_json &data )
                 debugmsg( "JSON source location has null path, data may load incorrectly" );
             } else {
                 try {
-                    shared_ptr_fast<std::istream> stream = get_cached_stream( *it->first.path );
-                    JsonIn jsin( *stream, it->first );
+                    shared_ptr_fast<const std::string> data = get_cached_data( *it->first.path );
+                    JsonIn jsin( *data, it->first );
                     JsonObject jo = jsin.get_object();
                     load_object( jo, it->second );
                 } catch( const JsonError &err ) {
@@ -174,8 +174,9 @@ void DynamicDataLoader::load_deferred( deferred_json &data )
                     debugmsg( "JSON source location has null path when reporting circular dependency" );
                 } else {
                     try {
-                        shared_ptr_fast<std::istream> stream = get_cached_stream( *it->first.path );
-                        JsonIn jsin( *stream, elem.first );
+                        shared_ptr_fast<const std::string> data =
+                            get_cached_data( *it->first.path );
+                        JsonIn jsin( *data, elem.first );
                         jsin.error( "JSON contains circular dependency, this object is discarded" );
                     } catch( const JsonError &err ) {
                         debugmsg( "(json-error)\n%s", err.what() );
@@ -453,6 +454,57 @@ void DynamicDataLoader::initialize()
 #endif
 }
 
+namespace
+{
+/**
+ * A data file read into memory and split into its top level objects.  The objects refer
+ * to @ref jsin, which reads from @ref data, so neither may move once the file is parsed.
+ */
+struct parsed_data_file {
+    std::string path;
+    std::string data;
+    // Key of the contents for the data cache
+    uint64_t hash = 0;
+    std::unique_ptr<JsonIn> jsin;
+    // A deque, as reallocating a vector would destroy copies of the objects, which reports
+    // their unvisited members.
+    std::deque<JsonObject> objects;
+    // Error that stopped the parsing after the objects above
+    std::string error;
+};
+} // namespace
+
+// This runs on worker threads, so errors are stored instead of thrown.  The objects are
+// only destroyed on the main thread, after they have been loaded.
+static void parse_data_file( parsed_data_file &file )
+{
+    file.data = read_entire_file( file.path );
+    file.hash = data_cache::content_hash( file.data );
+    try {
+        file.jsin = std::make_unique<JsonIn>( file.data, file.path );
+        JsonIn &jsin = *file.jsin;
+        if( jsin.test_object() ) {
+            file.objects.emplace_back( jsin );
+            // if there's anything else in the file, it's an error.
+            jsin.eat_whitespace();
+            if( jsin.good() ) {
+                jsin.error( string_format( "expected single-object file but found '%c'",
+                                           jsin.peek() ) );
+            }
+        } else if( jsin.test_array() ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                file.objects.emplace_back( jsin );
+            }
+        } else {
+            // not an object or an array?
+            jsin.error( "expected object or array" );
+        }
+    } catch( const std::exception &err ) {
+        file.error = err.what();
+    }
+}
+
 void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
         loading_ui &ui )
 {
@@ -474,51 +526,67 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back( path );
         }
     }
-    // iterate over each file
-    for( const std::string &file : files ) {
-        // and stuff it into ram
-        std::istringstream iss( read_entire_file( file ) );
-        try {
-            // parse it
-            JsonIn jsin( iss, file );
-            load_all_from_json( jsin, src, ui, path, file );
-        } catch( const JsonError &err ) {
-            throw std::runtime_error( err.what() );
+
+    // Reading and tokenizing the files does not touch any game data, so it runs on the
+    // worker threads.  The objects are then loaded on this thread in the same order as
+    // before, as later objects may copy from or override earlier ones.
+    std::vector<parsed_data_file> parsed( files.size() );
+    for( size_t i = 0; i < files.size(); ++i ) {
+        parsed[i].path = files[i];
+    }
+    const std::chrono::steady_clock::time_point parse_start = std::chrono::steady_clock::now();
+    const std::function<void( int )> parse = [&parsed]( int i ) {
+        parse_data_file( parsed[i] );
+    };
+    if( thread_pool *pool = get_thread_pool( data_loading_threads ) ) {
+        pool->parallel_for( 0, static_cast<int>( parsed.size() ), parse );
+    } else {
+        for( size_t i = 0; i < parsed.size(); ++i ) {
+            parse( static_cast<int>( i ) );
         }
     }
-}
 
-void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &,
-        const std::string &base_path, const std::string &full_path )
-{
-    if( jsin.test_object() ) {
-        // find type and dispatch single object
-        JsonObject jo = jsin.get_object();
-        load_object( jo, src, base_path, full_path );
-        jo.finish();
-        // if there's anything else in the file, it's an error.
-        jsin.eat_whitespace();
-        if( jsin.good() ) {
-            jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
+    std::vector<uint64_t> hashes;
+    hashes.reserve( parsed.size() );
+    for( const parsed_data_file &file : parsed ) {
+        hashes.push_back( file.hash );
+    }
+    loaded_data_key = data_cache::combine_keys( loaded_data_key,
+                      data_cache::files_key( files, hashes ) );
+    const std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
+
+    for( parsed_data_file &file : parsed ) {
+        try {
+            for( JsonObject &jo : file.objects ) {
+                load_object( jo, src, path, file.path );
+                jo.finish();
+            }
+        } catch( const JsonError &err ) {
+            throw std::runtime_error( err.what() );
         }
-    } else if( jsin.test_array() ) {
-        jsin.start_array();
-        // find type and dispatch each object until array close
-        while( !jsin.end_array() ) {
-            JsonObject jo = jsin.get_object();
-            load_object( jo, src, base_path, full_path );
-            jo.finish();
+        // Errors after the last complete object are raised once those have been loaded,
+        // just as if the file was read sequentially.
+        if( !file.error.empty() ) {
+            throw std::runtime_error( file.error );
         }
-    } else {
-        // not an object or an array?
-        jsin.error( "expected object or array" );
+        inp_mngr.pump_events();
     }
-    inp_mngr.pump_events();
+
+    const std::chrono::steady_clock::time_point load_end = std::chrono::steady_clock::now();
+    const int parse_ms = static_cast<int>( std::chrono::duration_cast<std::chrono::milliseconds>
+                                           ( load_start - parse_start ).count() );
+    const int load_ms = static_cast<int>( std::chrono::duration_cast<std::chrono::milliseconds>
+                                          ( load_end - load_start ).count() );
+    DebugLog( D_INFO, DC_ALL ) << "Loaded " << files.size() << " data files from " << path
+                               << ": parsing took " << parse_ms << " ms, loading took "
+                               << load_ms << " ms";
+    ui.set_details( string_format( _( "parse %d ms, load %d ms" ), parse_ms, load_ms ) );
 }
 
 void DynamicDataLoader::unload_data()
 {
     finalized = false;
+    loaded_data_key = 0;
 
     achievement::reset();
     activity_type::reset();
@@ -676,6 +744,7 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
             { _( "Harvest lists" ), &harvest_list::finalize_all },
             { _( "Anatomies" ), &anatomy::finalize_all },
             { _( "Mutations" ), &mutation_branch::finalize },
+            { _( "Scenarios" ), &scenario::finalize },
             { _( "Achievements" ), &achievement::finalize },
 #if defined(TILES)
             { _( "Tileset" ), &load_tileset },
@@ -693,7 +762,27 @@ void DynamicDataLoader::finalize_loaded_data( loading_ui &ui )
         ui.proceed();
     }
 
-    check_consistency( ui );
+    const data_cache::cache_mode cache_mode = data_cache::mode();
+    if( cache_mode == data_cache::cache_mode::enabled &&
+        data_cache::was_checked( loaded_data_key ) ) {
+        DebugLog( D_INFO, DC_ALL ) << "Skipped the consistency checks, the data passed them before";
+    } else {
+        if( cache_mode == data_cache::cache_mode::rebuild ) {
+            data_cache::clear_checked();
+        }
+        const bool recorded = cache_mode == data_cache::cache_mode::verify &&
+                              data_cache::was_checked( loaded_data_key );
+        check_consistency( ui );
+        const bool passed = !debug_has_error_been_observed();
+        if( recorded && !passed ) {
+            debugmsg( "The data cache recorded this data as passing the consistency checks, "
+                      "but it did not pass them now.  The cache is cleared." );
+            data_cache::clear_checked();
+        }
+        if( cache_mode != data_cache::cache_mode::disabled && passed ) {
+            data_cache::set_checked( loaded_data_key );
+        }
+    }
     finalized = true;
 }
 
@@ -701,6 +790,9 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
 {
     ui.new_context( _( "Verifying" ) );
 
+    // The data cache may skip these checks, so they must not change the loaded data.  Anything
+    // the game relies on belongs in finalize_loaded_data.
+
     using named_entry = std::pair<std::string, std::function<void()>>;
     const std::vector<named_entry> entries = {{
             { _( "Flags" ), &json_flag::check_consistency },
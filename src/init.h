@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_INIT_H
 #define CATA_SRC_INIT_H
 
+#include <cstdint>
 #include <functional>
 #include <iosfwd>
 #include <list>
@@ -13,7 +14,6 @@
 
 #include "memory_fast.h"
 
-class JsonIn;
 class JsonObject;
 class loading_ui;
 struct json_source_location;
@@ -70,6 +70,8 @@ class DynamicDataLoader
 
     private:
         bool finalized = false;
+        // Combined data cache key of all the data loaded since unload_data
+        uint64_t loaded_data_key = 0;
 
         struct cached_streams;
 
@@ -87,17 +89,6 @@ class DynamicDataLoader
         void add( const std::string &type,
                   const std::function<void( const JsonObject &, const std::string &, const std::string &, const std::string & )>
                   &f );
-        /**
-         * Load all the types from that json data.
-         * @param jsin Might contain single object,
-         * or an array of objects. Each object must have a
-         * "type", that is part of the @ref type_function_map
-         * @param src String identifier for mod this data comes from
-         * @param ui Finalization status display.
-         * @throws std::exception on all kind of errors.
-         */
-        void load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &ui,
-                                 const std::string &base_path, const std::string &full_path );
         /**
          * Load a single object from a json object.
          * @param jo The json object to load the C++-object from.
@@ -172,12 +163,17 @@ class DynamicDataLoader
         }
 
         /**
-         * Get a possibly cached stream for deferred data loading. If the cached
-         * stream is still in use by outside code, this returns a new stream to
-         * avoid conflict of stream cursor. The stream cursor is not reset if a
-         * cached stream is returned.
+         * Data cache key of all the data loaded since @ref unload_data, see data_cache.h.
+         */
+        uint64_t data_cache_key() const {
+            return loaded_data_key;
+        }
+
+        /**
+         * Get the possibly cached contents of a data file for deferred data loading.
+         * Any number of JsonIn instances can read them at the same time.
          */
-        shared_ptr_fast<std::istream> get_cached_stream( const std::string &path );
+        shared_ptr_fast<const std::string> get_cached_data( const std::string &path );
 };
 
 #endif // CATA_SRC_INIT_H
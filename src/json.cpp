@@ -2,6 +2,7 @@
 
 #include <clocale>
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cmath> // IWYU pragma: keep
 #include <cstdint>
@@ -89,34 +90,65 @@ JsonObject::JsonObject( JsonIn &j )
     while( !jsin->end_object() ) {
         std::string n = jsin->get_member_name();
         int p = jsin->tell();
-        if( positions.count( n ) > 0 ) {
+        const auto iter = std::lower_bound( positions.begin(), positions.end(), n,
+        []( const std::pair<std::string, int> &member, const std::string & name ) {
+            return member.first < name;
+        } );
+        if( iter != positions.end() && iter->first == n ) {
             j.error( "duplicate entry in json object" );
         }
-        positions[n] = p;
+        positions.emplace( iter, std::move( n ), p );
         jsin->skip_value();
     }
     end_ = jsin->tell();
     final_separator = jsin->get_ate_separator();
+#ifndef CATA_IN_TOOL
+    visited_members.assign( positions.size(), false );
+#endif
+}
+
+int JsonObject::member_index( const std::string &name ) const
+{
+    const auto iter = std::lower_bound( positions.begin(), positions.end(), name,
+    []( const std::pair<std::string, int> &member, const std::string & name ) {
+        return member.first < name;
+    } );
+    if( iter == positions.end() || iter->first != name ) {
+        return -1;
+    }
+    return static_cast<int>( iter - positions.begin() );
 }
 
 void JsonObject::mark_visited( const std::string &name ) const
 {
 #ifndef CATA_IN_TOOL
-    visited_members.emplace( name );
+    const int index = member_index( name );
+    if( index >= 0 ) {
+        visited_members[index] = true;
+    }
 #else
     static_cast<void>( name );
 #endif
 }
 
+void JsonObject::mark_member_visited( const size_t index ) const
+{
+#ifndef CATA_IN_TOOL
+    visited_members[index] = true;
+#else
+    static_cast<void>( index );
+#endif
+}
+
 void JsonObject::report_unvisited() const
 {
 #ifndef CATA_IN_TOOL
     if( report_unvisited_members && !reported_unvisited_members &&
         !std::uncaught_exception() ) {
         reported_unvisited_members = true;
-        for( const std::pair<const std::string, int> &p : positions ) {
-            const std::string &name = p.first;
-            if( !visited_members.count( name ) && !string_starts_with( name, "//" ) ) {
+        for( size_t i = 0; i < positions.size(); ++i ) {
+            const std::string &name = positions[i].first;
+            if( !visited_members[i] && !string_starts_with( name, "//" ) ) {
                 try {
                     throw_error( string_format( "Invalid or misplaced field name \"%s\" in JSON data", name ), name );
                 } catch( const JsonError &e ) {
@@ -156,7 +188,12 @@ void JsonObject::allow_omitted_members() const
 void JsonObject::copy_visited_members( const JsonObject &rhs ) const
 {
 #ifndef CATA_IN_TOOL
-    visited_members = rhs.visited_members;
+    visited_members.assign( positions.size(), false );
+    for( size_t i = 0; i < rhs.positions.size(); ++i ) {
+        if( rhs.visited_members[i] ) {
+            mark_visited( rhs.positions[i].first );
+        }
+    }
 #else
     static_cast<void>( rhs );
 #endif
@@ -173,8 +210,8 @@ int JsonObject::verify_position( const std::string &name,
         // so it will never indicate a valid member position
         return 0;
     }
-    const auto iter = positions.find( name );
-    if( iter == positions.end() ) {
+    const int index = member_index( name );
+    if( index < 0 ) {
         if( throw_exception ) {
             jsin->seek( start );
             jsin->error( "member not found: " + name );
@@ -183,12 +220,12 @@ int JsonObject::verify_position( const std::string &name,
         // so it will never indicate a valid member position
         return 0;
     }
-    return iter->second;
+    return positions[index].second;
 }
 
 bool JsonObject::has_member( const std::string &name ) const
 {
-    return positions.count( name ) > 0;
+    return member_index( name ) >= 0;
 }
 
 std::string JsonObject::line_number() const
@@ -754,11 +791,93 @@ void add_array_to_set( std::set<std::string> &s, const JsonObject &json, const s
     }
 }
 
+// Reads from a string without copying it. The whole string is the get area, so JsonIn can
+// scan it directly, and the stream functions continue where the scanning stopped.
+class json_streambuf : public std::streambuf
+{
+    public:
+        explicit json_streambuf( const std::string &data ) {
+            // The data is never written to, the get area just is not const
+            char *const begin = const_cast<char *>( data.data() );
+            setg( begin, begin, begin + data.size() );
+        }
+
+        const char *begin() const {
+            return eback();
+        }
+        const char *pos() const {
+            return gptr();
+        }
+        const char *end() const {
+            return egptr();
+        }
+        void set_pos( const char *p ) {
+            setg( eback(), const_cast<char *>( p ), egptr() );
+        }
+
+    protected:
+        pos_type seekoff( const off_type off, const std::ios_base::seekdir dir,
+                          const std::ios_base::openmode which ) override {
+            if( !( which & std::ios_base::in ) ) {
+                return pos_type( off_type( -1 ) );
+            }
+            const char *const base = dir == std::ios_base::beg ? eback() :
+                                     dir == std::ios_base::cur ? gptr() : egptr();
+            const off_type target = base - eback() + off;
+            if( target < 0 || target > egptr() - eback() ) {
+                return pos_type( off_type( -1 ) );
+            }
+            set_pos( eback() + target );
+            return pos_type( target );
+        }
+        pos_type seekpos( const pos_type pos, const std::ios_base::openmode which ) override {
+            return seekoff( off_type( pos ), std::ios_base::beg, which );
+        }
+};
+
+struct JsonIn::json_buffer {
+    json_streambuf buf;
+    std::istream stream;
+
+    explicit json_buffer( const std::string &data ) : buf( data ), stream( &buf ) {}
+
+    // Whether the data can be scanned directly, otherwise the stream handles the end of the
+    // data and its error states
+    bool readable() const {
+        return stream.good() && buf.pos() != buf.end();
+    }
+};
+
 JsonIn::JsonIn( std::istream &s ) : stream( &s )
 {
     sanity_check_stream();
 }
 
+JsonIn::JsonIn( const std::string &data ) : buffer( std::make_unique<json_buffer>( data ) )
+{
+    stream = &buffer->stream;
+    sanity_check_stream();
+}
+
+JsonIn::JsonIn( const std::string &data, const std::string &path )
+    : buffer( std::make_unique<json_buffer>( data ) )
+    , path( make_shared_fast<std::string>( path ) )
+{
+    stream = &buffer->stream;
+    sanity_check_stream();
+}
+
+JsonIn::JsonIn( const std::string &data, const json_source_location &loc )
+    : buffer( std::make_unique<json_buffer>( data ) )
+    , path( loc.path )
+{
+    stream = &buffer->stream;
+    seek( loc.offset );
+    sanity_check_stream();
+}
+
+JsonIn::~JsonIn() = default;
+
 JsonIn::JsonIn( std::istream &s, const std::string &path )
     : stream( &s )
     , path( make_shared_fast<std::string>( path ) )
@@ -783,10 +902,16 @@ void JsonIn::sanity_check_stream()
 
 int JsonIn::tell()
 {
+    if( buffer && !stream->fail() ) {
+        return static_cast<int>( buffer->buf.pos() - buffer->buf.begin() );
+    }
     return stream->tellg();
 }
 char JsonIn::peek()
 {
+    if( buffer && buffer->readable() ) {
+        return *buffer->buf.pos();
+    }
     return static_cast<char>( stream->peek() );
 }
 bool JsonIn::good()
@@ -803,11 +928,28 @@ void JsonIn::seek( int pos )
 
 void JsonIn::eat_whitespace()
 {
+    if( buffer && buffer->readable() ) {
+        const char *p = buffer->buf.pos();
+        const char *const end = buffer->buf.end();
+        while( p != end && is_whitespace( *p ) ) {
+            ++p;
+        }
+        buffer->buf.set_pos( p );
+    }
     while( is_whitespace( peek() ) ) {
         stream->get();
     }
 }
 
+void JsonIn::skip_char()
+{
+    if( buffer && buffer->readable() ) {
+        buffer->buf.set_pos( buffer->buf.pos() + 1 );
+    } else {
+        stream->get();
+    }
+}
+
 void JsonIn::uneat_whitespace()
 {
     while( tell() > 0 ) {
@@ -839,7 +981,7 @@ void JsonIn::skip_separator()
         if( ate_separator ) {
             error( "duplicate comma" );
         }
-        stream->get();
+        skip_char();
         ate_separator = true;
     } else if( ch == ']' || ch == '}' || ch == ':' ) {
         // okay
@@ -883,6 +1025,23 @@ void JsonIn::skip_string()
 {
     char ch;
     eat_whitespace();
+    if( buffer && buffer->readable() && peek() == '"' ) {
+        const char *const end = buffer->buf.end();
+        for( const char *p = buffer->buf.pos() + 1; p != end; ++p ) {
+            if( *p == '"' ) {
+                buffer->buf.set_pos( p + 1 );
+                end_value();
+                return;
+            } else if( *p == '\\' ) {
+                if( ++p == end ) {
+                    break;
+                }
+            } else if( *p == '\r' || *p == '\n' ) {
+                break;
+            }
+        }
+        // Errors are reported by reading it again below
+    }
     stream->get( ch );
     if( ch != '"' ) {
         std::stringstream err;
@@ -996,6 +1155,20 @@ void JsonIn::skip_number()
 {
     char ch;
     eat_whitespace();
+    if( buffer && buffer->readable() ) {
+        const char *p = buffer->buf.pos();
+        const char *const end = buffer->buf.end();
+        while( p != end && ( *p == '+' || *p == '-' || ( *p >= '0' && *p <= '9' ) ||
+                             *p == 'e' || *p == 'E' || *p == '.' ) ) {
+            ++p;
+        }
+        if( p != end ) {
+            buffer->buf.set_pos( p );
+            end_value();
+            return;
+        }
+        // Let the stream handle the end of the data
+    }
     // skip all of (+-0123456789.eE)
     while( stream->good() ) {
         stream->get( ch );
@@ -1015,22 +1188,22 @@ std::string JsonIn::get_member_name()
     return s;
 }
 
-static bool get_escaped_or_unicode( std::istream &stream, std::string &s, std::string &err )
+bool JsonIn::get_escaped_or_unicode( std::string &s, std::string &err )
 {
-    if( !stream.good() ) {
+    if( !stream->good() ) {
         err = "stream not good";
         return false;
     }
     char ch;
-    stream.get( ch );
-    if( !stream.good() ) {
+    stream->get( ch );
+    if( !stream->good() ) {
         err = "read operation failed";
         return false;
     }
     if( ch == '\\' ) {
         // converting \", \\, \/, \b, \f, \n, \r, \t and \uxxxx according to JSON spec.
-        stream.get( ch );
-        if( !stream.good() ) {
+        stream->get( ch );
+        if( !stream->good() ) {
             err = "read operation failed";
             return false;
         }
@@ -1062,8 +1235,8 @@ static bool get_escaped_or_unicode( std::istream &stream, std::string &s, std::s
             case 'u': {
                     uint32_t u = 0;
                     for( int i = 0; i < 4; ++i ) {
-                        stream.get( ch );
-                        if( !stream.good() ) {
+                        stream->get( ch );
+                        if( !stream->good() ) {
                             err = "read operation failed";
                             return false;
                         }
@@ -1123,8 +1296,8 @@ static bool get_escaped_or_unicode( std::istream &stream, std::string &s, std::s
         }
         s += ch;
         for( ; n > 0; --n ) {
-            stream.get( ch );
-            if( !stream.good() ) {
+            stream->get( ch );
+            if( !stream->good() ) {
                 err = "read operation failed";
                 return false;
             }
@@ -1144,10 +1317,34 @@ static bool get_escaped_or_unicode( std::istream &stream, std::string &s, std::s
     return true;
 }
 
+bool JsonIn::get_plain_string( std::string &s )
+{
+    if( !buffer || !buffer->readable() || peek() != '"' ) {
+        return false;
+    }
+    const char *const first = buffer->buf.pos() + 1;
+    const char *const end = buffer->buf.end();
+    for( const char *p = first; p != end; ++p ) {
+        const unsigned char ch = static_cast<unsigned char>( *p );
+        if( ch == '"' ) {
+            s.assign( first, p );
+            buffer->buf.set_pos( p + 1 );
+            return true;
+        } else if( ch == '\\' || ch < 0x20 || ch >= 0x80 ) {
+            return false;
+        }
+    }
+    return false;
+}
+
 std::string JsonIn::get_string()
 {
     eat_whitespace();
     std::string s;
+    if( get_plain_string( s ) ) {
+        end_value();
+        return s;
+    }
     char ch;
     std::string err;
     bool success = false;
@@ -1174,7 +1371,7 @@ std::string JsonIn::get_string()
                 success = true;
                 break;
             }
-            if( !get_escaped_or_unicode( *stream, s, err ) ) {
+            if( !get_escaped_or_unicode( s, err ) ) {
                 break;
             }
         } while( stream->good() );
@@ -1434,7 +1631,7 @@ void JsonIn::start_array()
 {
     eat_whitespace();
     if( peek() == '[' ) {
-        stream->get();
+        skip_char();
         ate_separator = false;
         return;
     } else {
@@ -1454,7 +1651,7 @@ bool JsonIn::end_array()
             uneat_whitespace();
             error( "comma not allowed at end of array" );
         }
-        stream->get();
+        skip_char();
         end_value();
         return true;
     } else {
@@ -1467,7 +1664,7 @@ void JsonIn::start_object()
 {
     eat_whitespace();
     if( peek() == '{' ) {
-        stream->get();
+        skip_char();
         ate_separator = false; // not that we want to
         return;
     } else {
@@ -1487,7 +1684,7 @@ bool JsonIn::end_object()
             uneat_whitespace();
             error( "comma not allowed at end of object" );
         }
-        stream->get();
+        skip_char();
         end_value();
         return true;
     } else {
@@ -1957,7 +2154,7 @@ void JsonIn::string_error( const std::string &message, const int offset )
         std::string s;
         std::string err;
         for( int i = 0; i < offset; ++i ) {
-            if( !get_escaped_or_unicode( *stream, s, err ) ) {
+            if( !get_escaped_or_unicode( s, err ) ) {
                 break;
             }
         }
@@ -2045,13 +2242,74 @@ JsonOut::JsonOut( std::ostream &s, bool pretty, int depth ) :
     stream->setf( std::ios_base::boolalpha );
 }
 
+JsonOut::~JsonOut()
+{
+    try {
+        flush();
+    } catch( const std::ios_base::failure & ) {
+        // Only thrown if exceptions are enabled on the stream, the failure
+        // still shows in the state of the stream.
+    }
+}
+
+void JsonOut::flush()
+{
+    if( !buffer.empty() ) {
+        stream->write( buffer.data(), buffer.size() );
+        buffer.clear();
+    }
+}
+
+void JsonOut::write_digits( unsigned long long val, const bool negative )
+{
+    std::array<char, 24> digits;
+    char *const end = digits.data() + digits.size();
+    char *first = end;
+    do {
+        *--first = static_cast<char>( '0' + val % 10 );
+        val /= 10;
+    } while( val != 0 );
+    if( negative ) {
+        *--first = '-';
+    }
+    put( first, end - first );
+}
+
+void JsonOut::write_float( const double val )
+{
+    // Large enough for the integer digits of the largest double
+    std::array<char, 512> formatted;
+    const int precision = std::min<int>( stream->precision(), 100 );
+    const int length = std::snprintf( formatted.data(), formatted.size(), "%#.*f", precision,
+                                      val );
+    if( length < 0 || static_cast<size_t>( length ) >= formatted.size() ) {
+        flush();
+        *stream << val;
+        return;
+    }
+    // snprintf uses the decimal point of the C locale, the stream the classic one
+    const char *const point = std::localeconv()->decimal_point;
+    if( point[0] != '.' || point[1] != '\0' ) {
+        std::string result( formatted.data(), length );
+        const size_t pos = result.find( point );
+        if( pos != std::string::npos ) {
+            result.replace( pos, std::strlen( point ), "." );
+        }
+        put( result.data(), result.size() );
+        return;
+    }
+    put( formatted.data(), length );
+}
+
 int JsonOut::tell()
 {
+    flush();
     return stream->tellp();
 }
 
 void JsonOut::seek( int pos )
 {
+    flush();
     stream->clear();
     stream->seekp( pos );
     need_separator = false;
@@ -2059,7 +2317,7 @@ void JsonOut::seek( int pos )
 
 void JsonOut::write_indent()
 {
-    std::fill_n( std::ostream_iterator<char>( *stream ), indent_level * 2, ' ' );
+    buffer.append( indent_level * 2, ' ' );
 }
 
 void JsonOut::write_separator()
@@ -2067,15 +2325,15 @@ void JsonOut::write_separator()
     if( !need_separator ) {
         return;
     }
-    stream->put( ',' );
+    put( ',' );
     if( pretty_print ) {
         // Wrap after separator between objects and between members of top-level objects.
         if( indent_level < 2 || need_wrap.back() ) {
-            stream->put( '\n' );
+            put( '\n' );
             write_indent();
         } else {
             // Otherwise pad after commas.
-            stream->put( ' ' );
+            put( ' ' );
         }
     }
     need_separator = false;
@@ -2084,11 +2342,12 @@ void JsonOut::write_separator()
 void JsonOut::write_member_separator()
 {
     if( pretty_print ) {
-        stream->write( ": ", 2 );
+        put( ": ", 2 );
     } else {
-        stream->put( ':' );
+        put( ':' );
     }
     need_separator = false;
+    value_written();
 }
 
 void JsonOut::start_pretty()
@@ -2097,11 +2356,11 @@ void JsonOut::start_pretty()
         indent_level += 1;
         // Wrap after top level object and array opening.
         if( indent_level < 2 || need_wrap.back() ) {
-            stream->put( '\n' );
+            put( '\n' );
             write_indent();
         } else {
             // Otherwise pad after opening.
-            stream->put( ' ' );
+            put( ' ' );
         }
     }
 }
@@ -2113,11 +2372,11 @@ void JsonOut::end_pretty()
         // Wrap after ending top level array and object.
         // Also wrap in the special case of exiting an array containing an object.
         if( indent_level < 1 || need_wrap.back() ) {
-            stream->put( '\n' );
+            put( '\n' );
             write_indent();
         } else {
             // Otherwise pad after ending.
-            stream->put( ' ' );
+            put( ' ' );
         }
     }
 }
@@ -2127,7 +2386,7 @@ void JsonOut::start_object( bool wrap )
     if( need_separator ) {
         write_separator();
     }
-    stream->put( '{' );
+    put( '{' );
     need_wrap.push_back( wrap );
     start_pretty();
     need_separator = false;
@@ -2137,8 +2396,9 @@ void JsonOut::end_object()
 {
     end_pretty();
     need_wrap.pop_back();
-    stream->put( '}' );
+    put( '}' );
     need_separator = true;
+    value_written();
 }
 
 void JsonOut::start_array( bool wrap )
@@ -2146,7 +2406,7 @@ void JsonOut::start_array( bool wrap )
     if( need_separator ) {
         write_separator();
     }
-    stream->put( '[' );
+    put( '[' );
     need_wrap.push_back( wrap );
     start_pretty();
     need_separator = false;
@@ -2156,8 +2416,9 @@ void JsonOut::end_array()
 {
     end_pretty();
     need_wrap.pop_back();
-    stream->put( ']' );
+    put( ']' );
     need_separator = true;
+    value_written();
 }
 
 void JsonOut::write_null()
@@ -2165,8 +2426,15 @@ void JsonOut::write_null()
     if( need_separator ) {
         write_separator();
     }
-    stream->write( "null", 4 );
+    put( "null", 4 );
     need_separator = true;
+    value_written();
+}
+
+// Whether the character has to be escaped in a JSON string
+static bool needs_escape( const unsigned char ch )
+{
+    return ch == '"' || ch == '\\' || ch < 0x20;
 }
 
 void JsonOut::write( const std::string &val )
@@ -2174,42 +2442,45 @@ void JsonOut::write( const std::string &val )
     if( need_separator ) {
         write_separator();
     }
-    stream->put( '"' );
-    for( const auto &i : val ) {
-        unsigned char ch = i;
+    put( '"' );
+    // Most strings, like all ids, need no escaping and are copied at once
+    const auto escaped = std::find_if( val.begin(), val.end(), []( const char ch ) {
+        return needs_escape( ch );
+    } );
+    put( val.data(), escaped - val.begin() );
+    for( auto it = escaped; it != val.end(); ++it ) {
+        unsigned char ch = *it;
         if( ch == '"' ) {
-            stream->write( "\\\"", 2 );
+            put( "\\\"", 2 );
         } else if( ch == '\\' ) {
-            stream->write( "\\\\", 2 );
-        } else if( ch == '/' ) {
-            // don't technically need to escape this
-            stream->put( '/' );
+            put( "\\\\", 2 );
         } else if( ch == '\b' ) {
-            stream->write( "\\b", 2 );
+            put( "\\b", 2 );
         } else if( ch == '\f' ) {
-            stream->write( "\\f", 2 );
+            put( "\\f", 2 );
         } else if( ch == '\n' ) {
-            stream->write( "\\n", 2 );
+            put( "\\n", 2 );
         } else if( ch == '\r' ) {
-            stream->write( "\\r", 2 );
+            put( "\\r", 2 );
         } else if( ch == '\t' ) {
-            stream->write( "\\t", 2 );
+            put( "\\t", 2 );
         } else if( ch < 0x20 ) {
             // convert to "\uxxxx" unicode escape
-            stream->write( "\\u00", 4 );
-            stream->put( ( ch < 0x10 ) ? '0' : '1' );
+            put( "\\u00", 4 );
+            put( ( ch < 0x10 ) ? '0' : '1' );
             char remainder = ch & 0x0F;
             if( remainder < 0x0A ) {
-                stream->put( '0' + remainder );
+                put( '0' + remainder );
             } else {
-                stream->put( 'A' + ( remainder - 0x0A ) );
+                put( 'A' + ( remainder - 0x0A ) );
             }
         } else {
-            stream->put( ch );
+            put( ch );
         }
     }
-    stream->put( '"' );
+    put( '"' );
     need_separator = true;
+    value_written();
 }
 
 template<size_t N>
@@ -2218,14 +2489,12 @@ void JsonOut::write( const std::bitset<N> &b )
     if( need_separator ) {
         write_separator();
     }
-    std::string converted = b.to_string();
-    stream->put( '"' );
-    for( auto &i : converted ) {
-        unsigned char ch = i;
-        stream->put( ch );
-    }
-    stream->put( '"' );
+    const std::string converted = b.to_string();
+    put( '"' );
+    put( converted.data(), converted.size() );
+    put( '"' );
     need_separator = true;
+    value_written();
 }
 
 void JsonOut::write( const JsonSerializer &thing )
@@ -2273,10 +2542,10 @@ JsonIn &JsonValue::seek() const
 
 JsonValue JsonObject::get_member( const std::string &name ) const
 {
-    const auto iter = positions.find( name );
-    if( !jsin || iter == positions.end() ) {
+    const int index = member_index( name );
+    if( !jsin || index < 0 ) {
         throw_error( "missing required field \"" + name + "\" in object: " + str() );
     }
-    mark_visited( name );
-    return JsonValue( *jsin, iter->second );
+    mark_member_visited( index );
+    return JsonValue( *jsin, positions[index].second );
 }
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -108,6 +109,10 @@ struct json_source_location {
  * The JsonIn class provides a wrapper around a std::istream,
  * with methods for reading JSON data directly from the stream.
  *
+ * It can also read from a string that is already in memory. That avoids copying
+ * the data into a stream, and lets the parser scan the data directly instead of
+ * going through the stream one character at a time, so prefer it for large inputs.
+ *
  * JsonObject and JsonArray provide higher-level wrappers,
  * and are a little easier to use in most cases,
  * but have the small overhead of indexing the members or elements before use.
@@ -185,7 +190,11 @@ struct json_source_location {
 class JsonIn
 {
     private:
+        struct json_buffer;
+
         std::istream *stream;
+        // Set when reading from memory, @ref stream then reads from it as well
+        std::unique_ptr<json_buffer> buffer;
         shared_ptr_fast<std::string> path;
         bool ate_separator = false;
 
@@ -193,13 +202,26 @@ class JsonIn
         void skip_separator();
         void skip_pair_separator();
         void end_value();
+        // Consumes the next character, which must have been peeked at
+        void skip_char();
+        bool get_escaped_or_unicode( std::string &s, std::string &err );
+        // Strings without escapes or non-ASCII characters straight from the buffer
+        bool get_plain_string( std::string &s );
 
     public:
         explicit JsonIn( std::istream &s );
         JsonIn( std::istream &s, const std::string &path );
         JsonIn( std::istream &s, const json_source_location &loc );
+        /** Reads from @p data, which must outlive this object. */
+        explicit JsonIn( const std::string &data );
+        JsonIn( const std::string &data, const std::string &path );
+        JsonIn( const std::string &data, const json_source_location &loc );
+        explicit JsonIn( std::string &&data ) = delete;
+        JsonIn( std::string &&data, const std::string &path ) = delete;
+        JsonIn( std::string &&data, const json_source_location &loc ) = delete;
         JsonIn( const JsonIn & ) = delete;
         JsonIn &operator=( const JsonIn & ) = delete;
+        ~JsonIn();
 
         shared_ptr_fast<std::string> get_path() const {
             return path;
@@ -619,6 +641,9 @@ class JsonIn
  * The JsonOut class provides a straightforward interface for outputting JSON.
  *
  * It wraps a std::ostream, providing methods for writing JSON data directly.
+ * The output is collected in a buffer and passed on to the stream in large blocks,
+ * and whenever a top level value is complete, so the stream can be written to
+ * directly between top level values.  Call flush() to pass on the output earlier.
  *
  * Typical usage might be as follows:
  *
@@ -650,11 +675,61 @@ class JsonOut
         std::vector<bool> need_wrap;
         int indent_level = 0;
         bool need_separator = false;
+        // Output not yet passed on to the stream
+        std::string buffer;
+        static constexpr size_t flush_size = 1 << 16;
+
+        void put( char c ) {
+            buffer.push_back( c );
+        }
+        void put( const char *data, size_t size ) {
+            buffer.append( data, size );
+        }
+        // Passes the output on if the buffer is full or no value is open any more
+        void value_written() {
+            if( need_wrap.empty() || buffer.size() >= flush_size ) {
+                flush();
+            }
+        }
+
+        void write_number( bool val ) {
+            if( val ) {
+                put( "true", 4 );
+            } else {
+                put( "false", 5 );
+            }
+        }
+        template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                  std::is_signed<T>::value, int>::type = 0>
+        void write_number( T val ) {
+            if( val < 0 ) {
+                // Negated as unsigned, so the minimum value does not overflow
+                write_digits( 0ULL - static_cast<unsigned long long>( val ), true );
+            } else {
+                write_digits( static_cast<unsigned long long>( val ), false );
+            }
+        }
+        template <typename T, typename std::enable_if<std::is_integral<T>::value &&
+                  std::is_unsigned<T>::value, int>::type = 0>
+        void write_number( T val ) {
+            write_digits( val, false );
+        }
+        template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+        void write_number( T val ) {
+            write_float( static_cast<double>( val ) );
+        }
+        void write_digits( unsigned long long val, bool negative );
+        // Formats like the stream would, with a fixed number of decimals
+        void write_float( double val );
 
     public:
         explicit JsonOut( std::ostream &stream, bool pretty_print = false, int depth = 0 );
         JsonOut( const JsonOut & ) = delete;
         JsonOut &operator=( const JsonOut & ) = delete;
+        ~JsonOut();
+
+        /** Passes all output written so far on to the stream. */
+        void flush();
 
         // punctuation
         void write_indent();
@@ -667,6 +742,7 @@ class JsonOut
             need_separator = true;
         }
         std::ostream *get_stream() {
+            flush();
             return stream;
         }
         int tell();
@@ -687,8 +763,9 @@ class JsonOut
             if( need_separator ) {
                 write_separator();
             }
-            *stream << val;
+            write_number( val );
             need_separator = true;
+            value_written();
         }
 
         /// Overload that calls a global function `serialize(const T&,JsonOut&)`, if available.
@@ -942,16 +1019,22 @@ class JsonOut
 class JsonObject
 {
     private:
-        std::map<std::string, int> positions;
+        // Name and value position of each member, sorted by name.  Objects have few
+        // members, so this is cheaper to build and search than a map.
+        std::vector<std::pair<std::string, int>> positions;
         int start;
         int end_;
         bool final_separator;
 #ifndef CATA_IN_TOOL
-        mutable std::set<std::string> visited_members;
+        // Whether each member in positions was visited
+        mutable std::vector<bool> visited_members;
         mutable bool report_unvisited_members = true;
         mutable bool reported_unvisited_members = false;
 #endif
+        // Index of the member in positions, or -1 if there is none
+        int member_index( const std::string &name ) const;
         void mark_visited( const std::string &name ) const;
+        void mark_member_visited( size_t index ) const;
         void report_unvisited() const;
 
         JsonIn *jsin;
@@ -1407,7 +1490,7 @@ class JsonObject::const_iterator
             return *this;
         }
         JsonMember operator*() const {
-            object_.mark_visited( iter_->first );
+            object_.mark_member_visited( iter_ - object_.positions.begin() );
             return JsonMember( iter_->first, JsonValue( *object_.jsin, iter_->second ) );
         }
 
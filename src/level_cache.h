@@ -7,6 +7,7 @@
 #include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "game_constants.h"
 #include "lightmap.h"
@@ -17,6 +18,36 @@
 
 class vehicle;
 
+// Light of a single stationary light source, kept until the source or the tiles it lights change.
+struct static_light_source {
+    float luminance = 0.0f;
+    // Luminance of the sources north, south, east and west of it, the light is only cast
+    // towards dimmer ones
+    std::array<float, 4> neighbors;
+    // Bounds of the tiles that got any light plus one tile around them, the transparency of
+    // other tiles does not matter
+    point footprint_min;
+    point footprint_max;
+    // Light and transparency within the footprint, column by column
+    std::vector<four_quadrants> lm;
+    std::vector<float> transparency;
+    // The light reached the edge of the map and was cut off there
+    bool clipped = false;
+};
+
+// Light cast by the stationary light sources of a level (terrain, furniture, items and fields),
+// kept per source so that only the sources whose surroundings changed are cast again.
+struct static_light_cache {
+    std::unordered_map<point, static_light_source> sources;
+    // The luminance of the sources
+    float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
+    // Absolute position of the map in submaps, the sources are kept in map coordinates
+    point abs_sub;
+    bool valid = false;
+    // The light of one source is cast here before it is copied to the source, all zero otherwise
+    four_quadrants scratch_lm[MAPSIZE_X][MAPSIZE_Y];
+};
+
 struct level_cache {
     public:
         // Zeros all relevant values
@@ -27,6 +58,9 @@ struct level_cache {
         bool outside_cache_dirty = false;
         bool floor_cache_dirty = false;
         bool seen_cache_dirty = false;
+        // Bumped whenever the transparency or floor cache of the level is rebuilt, or its seen
+        // cache is marked dirty. Invalidates the line of sight checks that involve the level.
+        int los_generation = 0;
         // This is a single value indicating that the entire level is floored.
         bool no_floor_gaps = false;
 
@@ -79,6 +113,9 @@ struct level_cache {
         cata::value_ptr<reachability_cache_vertical> r_up_cache =
             cata::make_value<reachability_cache_vertical>();
 
+        // allocated by the first map::generate_lightmap of the level
+        cata::value_ptr<static_light_cache> static_light;
+
         // stores resulting apparent brightness to player, calculated by map::apparent_light_at
         lit_level visibility_cache[MAPSIZE_X][MAPSIZE_Y];
         std::bitset<MAPSIZE_X *MAPSIZE_Y> map_memory_seen_cache;
@@ -37,6 +37,7 @@
 #include "point.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "type_id.h"
 #include "units.h"
@@ -110,8 +111,9 @@ bool map::build_transparency_cache( const int zlev )
 
     const float sight_penalty = get_weather().weather_id->sight_penalty;
 
-    // Traverse the submaps in order
-    for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+    // Each column of submaps only writes its own rows of the caches, so the columns can be
+    // built in parallel
+    const auto build_column = [&]( const int smx ) {
         for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
             const submap *cur_submap = get_submap_at_grid( {smx, smy, zlev} );
             if( cur_submap == nullptr ) {
@@ -185,6 +187,15 @@ bool map::build_transparency_cache( const int zlev )
                 }
             }
         }
+    };
+    thread_pool *pool = get_thread_pool( map_cache_threads );
+    // Missing submaps are reported with debugmsg, which has to happen on the main thread
+    if( pool != nullptr && all_submaps_loaded( zlev, zlev ) ) {
+        pool->parallel_for( 0, my_MAPSIZE, build_column );
+    } else {
+        for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+            build_column( smx );
+        }
     }
     map_cache.transparency_cache_dirty.reset();
     return true;
@@ -391,6 +402,9 @@ void map::build_sunlight_cache( int pzlev )
     }
 }
 
+// Keeps the light of the sources in the light_source_buffer of the cache in its static_light
+static void update_static_light( level_cache &cache, const point &abs_sub );
+
 void map::generate_lightmap( const int zlev )
 {
     auto &map_cache = get_cache( zlev );
@@ -500,6 +514,10 @@ void map::generate_lightmap( const int zlev )
         }
     }
 
+    // Only the light of the sources found so far can be kept from the last time, the creatures
+    // and vehicles are added on top of it below
+    update_static_light( map_cache, abs_sub.xy() );
+
     for( monster &critter : g->all_monsters() ) {
         if( critter.is_hallucination() ) {
             continue;
@@ -595,10 +613,23 @@ void map::generate_lightmap( const int zlev )
         unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
         buffered:   (12*4)*(160)   = apply_light_ray x 7680
     */
+    const static_light_cache &static_light = *map_cache.static_light;
+    for( const std::pair<const point, static_light_source> &elem : static_light.sources ) {
+        const static_light_source &source = elem.second;
+        sm[elem.first.x][elem.first.y] = std::max( sm[elem.first.x][elem.first.y],
+                                         source.luminance );
+        auto source_lm = source.lm.begin();
+        for( int x = source.footprint_min.x; x <= source.footprint_max.x; ++x ) {
+            for( int y = source.footprint_min.y; y <= source.footprint_max.y; ++y ) {
+                lm[x][y] = elementwise_max( lm[x][y], *source_lm++ );
+            }
+        }
+    }
+    // The sources added by vehicles
     const tripoint cache_start( 0, 0, zlev );
     const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
     for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x][p.y] > 0.0 ) {
+        if( light_source_buffer[p.x][p.y] > static_light.light_source_buffer[p.x][p.y] ) {
             apply_light_source( p, light_source_buffer[p.x][p.y] );
         }
     }
@@ -821,6 +852,42 @@ static constexpr quadrant quadrant_from_x_y( int x, int y )
            ( ( y > 0 ) ? quadrant::NE : quadrant::SE );
 }
 
+// Length of the run of tiles equal to value at the start of a row, see transparency_run_length
+template<typename T>
+static int row_run_length( const T *first, const int stride, const int count, const T &value )
+{
+    int i = 0;
+    while( i < count && first[i * stride] == value ) {
+        ++i;
+    }
+    return i;
+}
+
+static int row_run_length( const float *first, const int stride, const int count,
+                           const float &value )
+{
+    return transparency_run_length( first, stride, count, value );
+}
+
+// Applies update_output to a row of tiles that all receive the same value
+template<typename T, typename Out, void( *update_output )( Out &, const T &, quadrant )>
+struct row_update {
+    static void apply( Out *first, const int stride, const int count, const T &value,
+                       const quadrant q ) {
+        for( int i = 0; i < count; ++i ) {
+            update_output( first[i * stride], value, q );
+        }
+    }
+};
+
+template<>
+struct row_update<float, float, update_light> {
+    static void apply( float *first, const int stride, const int count, const float &value,
+                       const quadrant ) {
+        raise_to_at_least( first, stride, count, value );
+    }
+};
+
 template<int xx, int xy, int yx, int yy, typename T, typename Out,
          T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
@@ -844,6 +911,8 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                 const int row, float start, const float end, T cumulative_transparency )
 {
     constexpr quadrant quad = quadrant_from_x_y( -xx - xy, -yx - yy );
+    // Distance in memory between consecutive tiles of a row
+    constexpr int stride = xx * MAPSIZE_Y + yx;
     float newStart = 0.0f;
     float radius = 60.0f - offsetDistance;
     if( start < end ) {
@@ -890,7 +959,50 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
             }
 
             if( new_transparency == current_transparency ) {
-                newStart = leadingEdge;
+                // The following tiles with the same transparency don't split the span either,
+                // so handle the whole run at once.
+                int remaining = -delta.x;
+                if( xx != 0 ) {
+                    remaining = std::min( remaining, xx > 0 ? MAPSIZE_X - 1 - current.x : current.x );
+                }
+                if( yx != 0 ) {
+                    remaining = std::min( remaining, yx > 0 ? MAPSIZE_Y - 1 - current.y : current.y );
+                }
+                // Stop at the end of the span
+                int span_left = 0;
+                while( span_left < remaining &&
+                       !( end > ( delta.x + span_left + 1 - 0.5f ) / ( delta.y + 0.5f ) ) ) {
+                    ++span_left;
+                }
+                const int tile_index = current.x * MAPSIZE_Y + current.y;
+                const int run_end = row_run_length( &input_array[0][0] + tile_index + stride, stride,
+                                                    span_left, current_transparency );
+                const auto run_tile_dist = [&]( const int i ) {
+                    return rl_dist( tripoint_zero, delta + tripoint( i, 0, 0 ) ) + offsetDistance;
+                };
+                int intensity_dist = dist;
+                int next_dist = run_end > 0 ? run_tile_dist( 1 ) : dist;
+                for( int i = 1; i <= run_end; ) {
+                    // Tiles at the same distance get the same intensity
+                    const int run_dist = next_dist;
+                    int same_dist = 1;
+                    while( i + same_dist <= run_end &&
+                           ( next_dist = run_tile_dist( i + same_dist ) ) == run_dist ) {
+                        ++same_dist;
+                    }
+                    if( run_dist != intensity_dist ) {
+                        last_intensity = calc( numerator, cumulative_transparency, run_dist );
+                        intensity_dist = run_dist;
+                    }
+                    const quadrant q = check( current_transparency, last_intensity ) ?
+                                       quadrant::default_ : quad;
+                    row_update<T, Out, update_output>::apply(
+                        &output_cache[0][0] + tile_index + i * stride, stride, same_dist,
+                        last_intensity, q );
+                    i += same_dist;
+                }
+                delta.x += run_end;
+                newStart = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
                 continue;
             }
             // Only cast recursively if previous span was not opaque.
@@ -1119,21 +1231,11 @@ static bool light_check( const float &transparency, const float &intensity )
     return transparency > LIGHT_TRANSPARENCY_SOLID && intensity > LIGHT_AMBIENT_LOW;
 }
 
-void map::apply_light_source( const tripoint &p, float luminance )
+static void cast_light_source( four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                               const float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y],
+                               const float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y],
+                               const point &p2, float luminance )
 {
-    auto &cache = get_cache( p.z );
-    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
-    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
-    float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
-    float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
-
-    const point p2( p.xy() );
-
-    if( inbounds( p ) ) {
-        const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
-        lm[p2.x][p2.y] = elementwise_max( lm[p2.x][p2.y], min_light );
-        sm[p2.x][p2.y] = std::max( sm[p2.x][p2.y], luminance );
-    }
     if( luminance <= lit_level::LOW ) {
         return;
     } else if( luminance <= lit_level::BRIGHT_ONLY ) {
@@ -1199,6 +1301,156 @@ void map::apply_light_source( const tripoint &p, float luminance )
     }
 }
 
+void map::apply_light_source( const tripoint &p, float luminance )
+{
+    auto &cache = get_cache( p.z );
+    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
+    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
+
+    const point p2( p.xy() );
+
+    if( inbounds( p ) ) {
+        const float min_light = std::max( static_cast<float>( lit_level::LOW ), luminance );
+        lm[p2.x][p2.y] = elementwise_max( lm[p2.x][p2.y], min_light );
+        sm[p2.x][p2.y] = std::max( sm[p2.x][p2.y], luminance );
+    }
+    cast_light_source( lm, cache.transparency_cache, cache.light_source_buffer, p2, luminance );
+}
+
+// Luminance of the sources north, south, east and west of p, which decides where cast_light_source
+// casts the light of p to
+static std::array<float, 4> neighbor_luminance(
+    const float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y], const point &p )
+{
+    const int peer_inbounds = LIGHTMAP_CACHE_X - 1;
+    return {{
+            p.y != 0 ? light_source_buffer[p.x][p.y - 1] : 0.0f,
+            p.y != peer_inbounds ? light_source_buffer[p.x][p.y + 1] : 0.0f,
+            p.x != peer_inbounds ? light_source_buffer[p.x + 1][p.y] : 0.0f,
+            p.x != 0 ? light_source_buffer[p.x - 1][p.y] : 0.0f
+        }
+    };
+}
+
+static bool static_light_is_valid( const static_light_source &source, const point &p,
+                                   const level_cache &cache )
+{
+    if( source.luminance != cache.light_source_buffer[p.x][p.y] ||
+        source.neighbors != neighbor_luminance( cache.light_source_buffer, p ) ) {
+        return false;
+    }
+    const int height = source.footprint_max.y - source.footprint_min.y + 1;
+    for( int x = source.footprint_min.x; x <= source.footprint_max.x; ++x ) {
+        const float *transparency = &source.transparency[( x - source.footprint_min.x ) * height];
+        if( std::memcmp( transparency, &cache.transparency_cache[x][source.footprint_min.y],
+                         height * sizeof( float ) ) != 0 ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static static_light_source cast_static_light( static_light_cache &static_light,
+        const level_cache &cache, const point &p )
+{
+    static_light_source source;
+    source.luminance = cache.light_source_buffer[p.x][p.y];
+    source.neighbors = neighbor_luminance( cache.light_source_buffer, p );
+
+    auto &lm = static_light.scratch_lm;
+    const float min_light = std::max( static_cast<float>( lit_level::LOW ), source.luminance );
+    lm[p.x][p.y] = four_quadrants( min_light );
+    cast_light_source( lm, cache.transparency_cache, cache.light_source_buffer, p,
+                       source.luminance );
+
+    // Even through open air the light falls below LIGHT_AMBIENT_LOW within this distance
+    const int reach = static_cast<int>( source.luminance / LIGHT_AMBIENT_LOW ) + 1;
+    const point reach_min( std::max( p.x - reach, 0 ), std::max( p.y - reach, 0 ) );
+    const point reach_max( std::min( p.x + reach, MAPSIZE_X - 1 ),
+                           std::min( p.y + reach, MAPSIZE_Y - 1 ) );
+    point min = p;
+    point max = p;
+    for( int x = reach_min.x; x <= reach_max.x; ++x ) {
+        for( int y = reach_min.y; y <= reach_max.y; ++y ) {
+            if( lm[x][y].max() > 0.0f ) {
+                min = point( std::min( min.x, x ), std::min( min.y, y ) );
+                max = point( std::max( max.x, x ), std::max( max.y, y ) );
+            }
+        }
+    }
+    source.clipped = min.x == 0 || min.y == 0 || max.x == MAPSIZE_X - 1 || max.y == MAPSIZE_Y - 1;
+    source.footprint_min = point( std::max( min.x - 1, 0 ), std::max( min.y - 1, 0 ) );
+    source.footprint_max = point( std::min( max.x + 1, MAPSIZE_X - 1 ),
+                                  std::min( max.y + 1, MAPSIZE_Y - 1 ) );
+
+    const int height = source.footprint_max.y - source.footprint_min.y + 1;
+    for( int x = source.footprint_min.x; x <= source.footprint_max.x; ++x ) {
+        const int y = source.footprint_min.y;
+        source.lm.insert( source.lm.end(), &lm[x][y], &lm[x][y] + height );
+        source.transparency.insert( source.transparency.end(), &cache.transparency_cache[x][y],
+                                    &cache.transparency_cache[x][y] + height );
+        std::fill_n( &lm[x][y], height, four_quadrants( 0.0f ) );
+    }
+    return source;
+}
+
+// Moves the sources along with the map, the ones whose light is no longer completely on the map
+// are dropped
+static void shift_static_light( static_light_cache &static_light, const point &abs_sub )
+{
+    const point offset = sm_to_ms_copy( static_light.abs_sub - abs_sub );
+    std::unordered_map<point, static_light_source> shifted;
+    for( std::pair<const point, static_light_source> &elem : static_light.sources ) {
+        static_light_source &source = elem.second;
+        const point min = source.footprint_min + offset;
+        const point max = source.footprint_max + offset;
+        if( source.clipped || min.x < 0 || min.y < 0 || max.x >= MAPSIZE_X || max.y >= MAPSIZE_Y ) {
+            continue;
+        }
+        source.footprint_min = min;
+        source.footprint_max = max;
+        shifted.emplace( elem.first + offset, std::move( source ) );
+    }
+    static_light.sources = std::move( shifted );
+    static_light.abs_sub = abs_sub;
+}
+
+static void update_static_light( level_cache &cache, const point &abs_sub )
+{
+    if( !cache.static_light ) {
+        cache.static_light = cata::make_value<static_light_cache>();
+    }
+    static_light_cache &static_light = *cache.static_light;
+    if( !static_light.valid ) {
+        static_light.sources.clear();
+        std::fill_n( &static_light.scratch_lm[0][0], MAPSIZE_X * MAPSIZE_Y,
+                     four_quadrants( 0.0f ) );
+        static_light.abs_sub = abs_sub;
+        static_light.valid = true;
+    } else if( static_light.abs_sub != abs_sub ) {
+        shift_static_light( static_light, abs_sub );
+    }
+
+    // Only the sources that are gone or whose surroundings changed need their light cast again
+    for( auto it = static_light.sources.begin(); it != static_light.sources.end(); ) {
+        if( static_light_is_valid( it->second, it->first, cache ) ) {
+            ++it;
+        } else {
+            it = static_light.sources.erase( it );
+        }
+    }
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            const point p( x, y );
+            if( cache.light_source_buffer[x][y] > 0.0f && !static_light.sources.count( p ) ) {
+                static_light.sources.emplace( p, cast_static_light( static_light, cache, p ) );
+            }
+        }
+    }
+    std::memcpy( static_light.light_source_buffer, cache.light_source_buffer,
+                 sizeof( cache.light_source_buffer ) );
+}
+
 void map::apply_directional_light( const tripoint &p, int direction, float luminance )
 {
     const point p2( p.xy() );
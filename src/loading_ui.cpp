@@ -36,6 +36,18 @@ void loading_ui::add_entry( const std::string &description )
     }
 }
 
+void loading_ui::set_details( const std::string &details )
+{
+    if( menu != nullptr && menu->selected >= 0 &&
+        menu->selected < static_cast<int>( menu->entries.size() ) ) {
+        menu->entries[menu->selected].ctxt = details;
+        if( ui != nullptr ) {
+            // The column width is only computed when the menu is laid out
+            ui->mark_resize();
+        }
+    }
+}
+
 void loading_ui::new_context( const std::string &desc )
 {
     if( menu != nullptr ) {
@@ -29,6 +29,10 @@ class loading_ui
          * Adds a named entry in the current loading context.
          */
         void add_entry( const std::string &description );
+        /**
+         * Shows additional text, like how long it took, next to the current entry.
+         */
+        void set_details( const std::string &details );
         /**
          * Place the UI onto UI stack, mark current entry as processed, scroll down,
          * and redraw. (if display is enabled)
@@ -0,0 +1,50 @@
+#include "los_cache.h"
+
+#include "game_constants.h"
+#include "point.h"
+
+// 64k entries of 16 bytes each
+static constexpr int los_cache_bits = 16;
+static constexpr size_t los_cache_size = size_t( 1 ) << los_cache_bits;
+// Packed keys only use the lower 48 bits, so this never matches a real key
+static constexpr uint64_t empty_key = UINT64_MAX;
+
+uint64_t los_cache::make_key( const tripoint &a, const tripoint &b )
+{
+    const tripoint &min = a < b ? a : b;
+    const tripoint &max = a < b ? b : a;
+    const auto pack = []( const tripoint & p ) {
+        return static_cast<uint64_t>( p.x & 0xFF ) << 16 | static_cast<uint64_t>( p.y & 0xFF ) << 8 |
+               static_cast<uint64_t>( ( p.z + OVERMAP_DEPTH ) & 0xFF );
+    };
+    return pack( min ) << 24 | pack( max );
+}
+
+size_t los_cache::slot( const uint64_t key )
+{
+    // Fibonacci hashing, neighbouring endpoints end up far apart
+    return static_cast<size_t>( ( key * 0x9E3779B97F4A7C15ULL ) >> ( 64 - los_cache_bits ) );
+}
+
+int los_cache::get( const tripoint &a, const tripoint &b, const int generation ) const
+{
+    if( entries.empty() ) {
+        return -1;
+    }
+    const uint64_t key = make_key( a, b );
+    const entry &e = entries[slot( key )];
+    if( e.key != key || e.generation != generation ) {
+        return -1;
+    }
+    return e.visible ? 1 : 0;
+}
+
+void los_cache::insert( const tripoint &a, const tripoint &b, const int generation,
+                        const bool visible )
+{
+    if( entries.empty() ) {
+        entries.assign( los_cache_size, entry{ empty_key, 0, false } );
+    }
+    const uint64_t key = make_key( a, b );
+    entries[slot( key )] = entry{ key, generation, visible };
+}
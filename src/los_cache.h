@@ -0,0 +1,42 @@
+#pragma once
+#ifndef CATA_SRC_LOS_CACHE_H
+#define CATA_SRC_LOS_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct tripoint;
+
+/**
+ * Fixed-size cache of line of sight checks between two points of the reality bubble.
+ * Coordinates are map-local and must be inbounds.
+ *
+ * The cache is direct-mapped: every pair of endpoints has a single slot, and storing a result
+ * replaces whatever was in that slot before.  Each result is stored with a generation supplied
+ * by the caller and is only returned for the same generation, so results are invalidated by
+ * changing the generation instead of clearing the cache.
+ */
+class los_cache
+{
+    public:
+        /** Result for the endpoints, -1 if there is none for this generation. */
+        int get( const tripoint &a, const tripoint &b, int generation ) const;
+        void insert( const tripoint &a, const tripoint &b, int generation, bool visible );
+
+    private:
+        struct entry {
+            uint64_t key;
+            int generation;
+            bool visible;
+        };
+
+        // Order-independent key of the endpoints, so the cache is reflexive
+        static uint64_t make_key( const tripoint &a, const tripoint &b );
+        static size_t slot( uint64_t key );
+
+        // Allocated on first insert, as most maps never check line of sight
+        std::vector<entry> entries;
+};
+
+#endif // CATA_SRC_LOS_CACHE_H
@@ -28,6 +28,7 @@
 #include "compatibility.h"
 #include "crash.h"
 #include "cursesdef.h"
+#include "data_cache.h"
 #include "debug.h"
 #include "filesystem.h"
 #include "game.h"
@@ -35,11 +36,13 @@
 #include "input.h"
 #include "loading_ui.h"
 #include "main_menu.h"
+#include "mapbuffer.h"
 #include "mapsharing.h"
 #include "memory_fast.h"
 #include "options.h"
 #include "output.h"
 #include "path_info.h"
+#include "region_file.h"
 #include "rng.h"
 #include "translations.h"
 #include "type_id.h"
@@ -116,6 +119,8 @@ void exit_handler( int s )
     const int old_timeout = inp_mngr.get_timeout();
     inp_mngr.reset_timeout();
     if( s != 2 || query_yn( _( "Really Quit?  All unsaved changes will be lost." ) ) ) {
+        // The map files of the last save may still be written in the background
+        MAPBUFFER.wait_for_pending_save();
         deinitDebug();
 
         int exit_status = 0;
@@ -233,6 +238,7 @@ struct cli_opts {
     dump_mode dmode = dump_mode::TSV;
     std::vector<std::string> opts;
     std::string world; /** if set try to load first save in this world on startup */
+    std::string migrate_maps; /** if set move the map files of this world directory into regions */
 };
 
 cli_opts parse_commandline( int argc, const char **argv )
@@ -242,7 +248,7 @@ cli_opts parse_commandline( int argc, const char **argv )
     const char *section_default = nullptr;
     const char *section_map_sharing = "Map sharing";
     const char *section_user_directory = "User directories";
-    const std::array<arg_handler, 12> first_pass_arguments = {{
+    const std::array<arg_handler, 15> first_pass_arguments = {{
             {
                 "--seed", "<string of letters and or numbers>",
                 "Sets the random number generator's seed value",
@@ -306,6 +312,36 @@ cli_opts parse_commandline( int argc, const char **argv )
                     return 0;
                 }
             },
+            {
+                "--migrate-maps", "<world directory>",
+                "Moves the map files of a world saved by older versions into region files",
+                section_default,
+                1,
+                [&result]( int, const char **params ) -> int {
+                    result.migrate_maps = params[0];
+                    return 1;
+                }
+            },
+            {
+                "--rebuild-data-cache", nullptr,
+                "Forgets which game data passed the consistency checks and checks it again",
+                section_default,
+                0,
+                []( int, const char ** ) -> int {
+                    data_cache::set_mode( data_cache::cache_mode::rebuild );
+                    return 0;
+                }
+            },
+            {
+                "--verify-data-cache", nullptr,
+                "Checks the game data even if the data cache says it passed the checks before",
+                section_default,
+                0,
+                []( int, const char ** ) -> int {
+                    data_cache::set_mode( data_cache::cache_mode::verify );
+                    return 0;
+                }
+            },
             {
                 "--world", "<name>",
                 "Load world",
@@ -576,6 +612,20 @@ int main( int argc, const char *argv[] )
 
     setupDebug( DebugOutput::file );
 
+    if( !cli.migrate_maps.empty() ) {
+        try {
+            const int migrated = migrate_quad_files_to_regions( cli.migrate_maps + "/maps" );
+            std::cout << "Moved " << migrated << " map quads into region files" << std::endl;
+            DebugLog( D_INFO, D_MAIN ) << "Moved " << migrated << " map quads of "
+                                       << cli.migrate_maps << " into region files";
+            return 0;
+        } catch( const std::exception &err ) {
+            std::cerr << "Migrating the maps failed: " << err.what() << std::endl;
+            DebugLog( D_ERROR, D_MAIN ) << "Migrating the maps failed: " << err.what();
+            return 1;
+        }
+    }
+
     /**
      * OS X does not populate locale env vars correctly (they usually default to
      * "C") so don't bother trying to set the locale based on them.
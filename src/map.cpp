@@ -45,6 +45,7 @@
 #include "fungal_effects.h"
 #include "game.h"
 #include "harvest.h"
+#include "hierarchical_pathfinding.h"
 #include "iexamine.h"
 #include "item.h"
 #include "item_factory.h"
@@ -84,6 +85,7 @@
 #include "sounds.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "timed_event.h"
 #include "translations.h"
@@ -97,6 +99,7 @@
 #include "vpart_position.h"
 #include "vpart_range.h"
 #include "weather.h"
+#include "weather_type.h"
 #include "weighted_list.h"
 
 static const itype_id itype_battery( "battery" );
@@ -1403,7 +1406,7 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture, const bool
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     // Make sure the furniture falls if it needs to
     support_dirty( p );
@@ -1717,7 +1720,7 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     tripoint above( p.xy(), p.z + 1 );
     // Make sure that if we supported something and no longer do so, it falls down
@@ -2735,30 +2738,28 @@ void map::decay_fields_and_scent( const time_duration &amount )
                 continue;
             }
 
-            for( int sx = 0; sx < SEEX; ++sx ) {
+            for( const point &sp : cur_submap->get_field_tiles() ) {
                 if( to_proc < 1 ) {
                     // This submap had some fields, but all got proc'd already
                     break;
                 }
 
-                for( int sy = 0; sy < SEEY; ++sy ) {
-                    const point p( sx + smx * SEEX, sy + smy * SEEY );
+                const point p( sp.x + smx * SEEX, sp.y + smy * SEEY );
 
-                    const field &fields = cur_submap->get_field( { sx, sy} );
-                    if( !outside_cache[p.x][p.y] ) {
-                        to_proc -= fields.field_count();
-                        continue;
-                    }
+                const field &fields = cur_submap->get_field( sp );
+                if( !outside_cache[p.x][p.y] ) {
+                    to_proc -= fields.field_count();
+                    continue;
+                }
 
-                    for( const auto &fp : fields ) {
-                        to_proc--;
-                        field_entry cur = fp.second;
-                        const field_type_id type = cur.get_field_type();
-                        const int decay_amount_factor =  type.obj().decay_amount_factor;
-                        if( decay_amount_factor != 0 ) {
-                            const time_duration decay_amount = amount / decay_amount_factor;
-                            cur.set_field_age( cur.get_field_age() + decay_amount );
-                        }
+                for( const auto &fp : fields ) {
+                    to_proc--;
+                    field_entry cur = fp.second;
+                    const field_type_id type = cur.get_field_type();
+                    const int decay_amount_factor =  type.obj().decay_amount_factor;
+                    if( decay_amount_factor != 0 ) {
+                        const time_duration decay_amount = amount / decay_amount_factor;
+                        cur.set_field_age( cur.get_field_age() + decay_amount );
                     }
                 }
             }
@@ -5358,9 +5359,9 @@ bool map::add_field( const tripoint &p, const field_type_id &type_id, int intens
     current_submap->is_uniform = false;
     invalidate_max_populated_zlev( p.z );
 
-    if( current_submap->get_field( l ).add_field( type_id, intensity, age ) ) {
-        //Only adding it to the count if it doesn't exist.
-        if( !current_submap->field_count++ ) {
+    if( current_submap->add_field( l, type_id, intensity, age ) ) {
+        // The first field of the submap, it has to be processed from now on.
+        if( current_submap->field_count == 1 ) {
             get_cache( p.z ).field_cache.set( static_cast<size_t>( p.x / SEEX + ( (
                                                   p.y / SEEX ) * MAPSIZE ) ) );
         }
@@ -5398,7 +5399,7 @@ void map::on_field_modified( const tripoint &p, const field_type &fd_type )
     }
 
     if( fd_type.is_dangerous() ) {
-        set_pathfinding_cache_dirty( p.z );
+        set_pathfinding_cache_dirty( p );
     }
 
     // Ensure blood type fields don't hang in the air
@@ -6085,17 +6086,17 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         bresenham_slope = 0;
         return false; // Out of range!
     }
-    // Cannonicalize the order of the tripoints so the cache is reflexive.
-    const tripoint &min = F < T ? F : T;
-    const tripoint &max = !( F < T ) ? F : T;
-    // A little gross, just pack the values into a point.
-    const point key(
-        min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
-        max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH )
-    );
-    char cached = skew_vision_cache.get( key, -1 );
-    if( cached >= 0 ) {
-        return cached > 0;
+    // The result depends on the levels between the endpoints
+    const bool cacheable = inbounds( F );
+    int generation = 0;
+    for( int z = std::min( F.z, T.z ); cacheable && z <= std::max( F.z, T.z ); z++ ) {
+        generation += get_cache_ref( z ).los_generation;
+    }
+    if( cacheable ) {
+        const int cached = skew_vision_cache.get( F, T, generation );
+        if( cached >= 0 ) {
+            return cached > 0;
+        }
     }
     bool visible = true;
 
@@ -6113,7 +6114,9 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
             }
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        if( cacheable ) {
+            skew_vision_cache.insert( F, T, generation, visible );
+        }
         return visible;
     }
 
@@ -6146,7 +6149,9 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    if( cacheable ) {
+        skew_vision_cache.insert( F, T, generation, visible );
+    }
     return visible;
 }
 
@@ -6564,6 +6569,37 @@ shift_bitset_cache<MAPSIZE_X, SEEX>( std::bitset<MAPSIZE_X *MAPSIZE_X> &cache,
 template void
 shift_bitset_cache<MAPSIZE, 1>( std::bitset<MAPSIZE *MAPSIZE> &cache, const point &s );
 
+void map::prefetch_ahead( const point &direction, const int distance ) const
+{
+    if( direction == point_zero || distance <= 0 ) {
+        return;
+    }
+    const tripoint abs = get_abs_sub();
+    const int zmin = zlevels ? -OVERMAP_DEPTH : abs.z;
+    const int zmax = zlevels ? OVERMAP_HEIGHT : abs.z;
+    // Whether a grid position outside the map is in the band the map moves into
+    const auto ahead = [&]( const int grid, const int dir ) {
+        if( grid >= 0 && grid < my_MAPSIZE ) {
+            return true;
+        }
+        return dir > 0 ? grid >= my_MAPSIZE : dir < 0 && grid < 0;
+    };
+    std::vector<tripoint> positions;
+    for( int gridx = -distance; gridx < my_MAPSIZE + distance; gridx++ ) {
+        for( int gridy = -distance; gridy < my_MAPSIZE + distance; gridy++ ) {
+            const bool inside = gridx >= 0 && gridx < my_MAPSIZE && gridy >= 0 &&
+                                gridy < my_MAPSIZE;
+            if( inside || !ahead( gridx, direction.x ) || !ahead( gridy, direction.y ) ) {
+                continue;
+            }
+            for( int gridz = zmin; gridz <= zmax; gridz++ ) {
+                positions.emplace_back( abs.x + gridx, abs.y + gridy, gridz );
+            }
+        }
+    }
+    MAPBUFFER.prefetch( positions );
+}
+
 void map::shift( const point &sp )
 {
     // Special case of 0-shift; refresh the map
@@ -8014,17 +8050,40 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
     bool seen_cache_dirty = false;
+    // The caches of a z-level only depend on the submaps of that level and the one below, so the
+    // levels can be built in parallel.  Anything touching other levels happens afterwards.
+    std::array<bool, OVERMAP_LAYERS> transparency_caches_dirty;
+    std::array<bool, OVERMAP_LAYERS> floor_caches_dirty;
+    const auto build_level_caches = [&]( const int z ) {
+        build_outside_cache( z );
+        transparency_caches_dirty[z + OVERMAP_DEPTH] = build_transparency_cache( z );
+        floor_caches_dirty[z + OVERMAP_DEPTH] = build_floor_cache( z );
+    };
+    thread_pool *pool = get_thread_pool( map_cache_threads );
+    // The builders report missing submaps with debugmsg, which has to happen on the main thread
+    if( pool != nullptr && all_submaps_loaded( minz - ( minz > -OVERMAP_DEPTH ? 1 : 0 ), maxz ) ) {
+        // string_id caches the result of its first lookup, do it before the workers race for it
+        get_weather().weather_id.obj();
+        pool->parallel_for( minz, maxz + 1, build_level_caches );
+    } else {
+        for( int z = minz; z <= maxz; z++ ) {
+            build_level_caches( z );
+        }
+    }
     for( int z = minz; z <= maxz; z++ ) {
         // trigger FOV recalculation only when there is a change on the player's level or if fov_3d is enabled
         const bool affects_seen_cache =  z == zlev || fov_3d;
-        build_outside_cache( z );
-        build_transparency_cache( z );
-        bool floor_cache_was_dirty = build_floor_cache( z );
+        const bool floor_cache_was_dirty = floor_caches_dirty[z + OVERMAP_DEPTH];
         seen_cache_dirty |= ( floor_cache_was_dirty && affects_seen_cache );
         if( floor_cache_was_dirty && z > -OVERMAP_DEPTH ) {
             get_cache( z - 1 ).r_up_cache->invalidate();
         }
-        seen_cache_dirty |= get_cache( z ).seen_cache_dirty && affects_seen_cache;
+        level_cache &ch = get_cache( z );
+        seen_cache_dirty |= ch.seen_cache_dirty && affects_seen_cache;
+        if( transparency_caches_dirty[z + OVERMAP_DEPTH] || floor_cache_was_dirty ||
+            ch.seen_cache_dirty ) {
+            ch.los_generation++;
+        }
     }
     // needs a separate pass as it changes the caches on neighbour z-levels (e.g. floor_cache);
     // otherwise such changes might be overwritten by main cache-building logic
@@ -8034,9 +8093,6 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
 
     seen_cache_dirty |= build_vision_transparency_cache( zlev );
 
-    if( seen_cache_dirty ) {
-        skew_vision_cache.clear();
-    }
     // Initial value is illegal player position.
     const tripoint &p = get_player_character().pos();
     static tripoint player_prev_pos;
@@ -8102,6 +8158,20 @@ submap *map::get_submap_at( const tripoint &p ) const
     return unsafe_get_submap_at( p );
 }
 
+bool map::all_submaps_loaded( const int minz, const int maxz ) const
+{
+    for( int z = minz; z <= maxz; z++ ) {
+        for( int smx = 0; smx < my_MAPSIZE; ++smx ) {
+            for( int smy = 0; smy < my_MAPSIZE; ++smy ) {
+                if( get_submap_at_grid( { smx, smy, z } ) == nullptr ) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
 submap *map::get_submap_at_grid( const tripoint &gridp ) const
 {
     return getsubmap( get_nonant( gridp ) );
@@ -8555,6 +8625,8 @@ const level_cache &map::access_cache( int zlev ) const
 pathfinding_cache::pathfinding_cache()
 {
     dirty = true;
+    dirty_submaps.set();
+    submap_generation.fill( 0 );
 }
 
 pathfinding_cache::~pathfinding_cache() = default;
@@ -8567,7 +8639,18 @@ pathfinding_cache &map::get_pathfinding_cache( int zlev ) const
 void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
-        get_pathfinding_cache( zlev ).dirty = true;
+        pathfinding_cache &cache = get_pathfinding_cache( zlev );
+        cache.dirty = true;
+        cache.dirty_submaps.set();
+    }
+}
+
+void map::set_pathfinding_cache_dirty( const tripoint &p )
+{
+    if( inbounds( p ) ) {
+        pathfinding_cache &cache = get_pathfinding_cache( p.z );
+        cache.dirty = true;
+        cache.dirty_submaps.set( ( p.x / SEEX ) * MAPSIZE + p.y / SEEY );
     }
 }
 
@@ -8660,6 +8743,13 @@ void map::update_pathfinding_cache( int zlev ) const
         }
     }
 
+    cache.generation++;
+    for( size_t i = 0; i < cache.dirty_submaps.size(); ++i ) {
+        if( cache.dirty_submaps[i] ) {
+            cache.submap_generation[i] = cache.generation;
+        }
+    }
+    cache.dirty_submaps.reset();
     cache.dirty = false;
 }
 
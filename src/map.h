@@ -31,7 +31,7 @@
 #include "level_cache.h"
 #include "lightmap.h"
 #include "line.h"
-#include "lru_cache.h"
+#include "los_cache.h"
 #include "map_selector.h"
 #include "mapdata.h"
 #include "optional.h"
@@ -90,7 +90,10 @@ using VehicleList = std::vector<wrapped_vehicle>;
 class map;
 
 enum ter_bitflags : int;
+enum pf_special : int;
+class pathfinding_hierarchy;
 struct pathfinding_cache;
+struct pathfinding_field;
 struct pathfinding_settings;
 template<typename T>
 struct weighted_int_list;
@@ -397,6 +400,8 @@ class map
         }
 
         void set_pathfinding_cache_dirty( int zlev );
+        /** Like above, but only the submap containing p has changed. */
+        void set_pathfinding_cache_dirty( const tripoint &p );
         /*@}*/
 
         void set_memory_seen_cache_dirty( const tripoint &p ) {
@@ -541,6 +546,12 @@ class map
          * Note: the map must have been loaded before this can be called.
          */
         void shift( const point &s );
+        /**
+         * Starts reading the submaps that the next shifts along @p direction would load,
+         * see @ref mapbuffer::prefetch.
+         * @param distance How many shifts to look ahead.
+         */
+        void prefetch_ahead( const point &direction, int distance ) const;
         /**
          * Moves the map vertically to (not by!) newz.
          * Does not actually shift anything, only forces cache updates.
@@ -707,6 +718,9 @@ class map
         /**
          * Calculate the best path using A*
          *
+         * Long routes on a single z-level are first planned on the submap level and then
+         * refined, see @ref pathfinding_hierarchy.
+         *
          * @param f The source location from which to path.
          * @param t The destination to which to path.
          * @param settings Structure describing pathfinding parameters.
@@ -716,6 +730,18 @@ class map
                                      const pathfinding_settings &settings,
         const std::set<tripoint> &pre_closed = {{ }} ) const;
 
+        /**
+         * Next step of the best path from f to t, read from a distance field shared by all
+         * callers heading to t with the same settings.  The field is only built once enough
+         * callers asked for the same target within a turn, and is rebuilt when the pathfinding
+         * cache of its z-level changes.
+         *
+         * @return The next step, or nothing if there is no field (yet) or t can't be reached from f.
+         * Callers should fall back to @ref route in that case.
+         */
+        cata::optional<tripoint> shared_route_step( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings ) const;
+
         // Vehicles: Common to 2D and 3D
         VehicleList get_vehicles();
         void add_vehicle_to_cache( vehicle * );
@@ -1782,6 +1808,8 @@ class map
         bool build_vision_transparency_cache( int zlev );
         // fills lm with sunlight. pzlev is current player's zlevel
         void build_sunlight_cache( int pzlev );
+        // Whether the submaps of all z-levels in [minz, maxz] are loaded
+        bool all_submaps_loaded( int minz, int maxz ) const;
     public:
         void build_outside_cache( int zlev );
         // Get a bitmap indicating which layers are potentially visible from the target layer.
@@ -1898,6 +1926,30 @@ class map
         int bash_rating_internal( int str, const furn_t &furniture,
                                   const ter_t &terrain, bool allow_floor,
                                   const vehicle *veh, int part ) const;
+        /**
+         * Cost of stepping from cur onto the adjacent tile p, which isn't plain flat ground,
+         * as used by the pathfinders.  Doesn't include the diagonal, trap or sharp penalties.
+         * @return The cost, or one of the negative pf_step_* values if p can't be entered.
+         */
+        int route_step_cost( const tripoint &cur, const tripoint &p, pf_special p_special,
+                             const pathfinding_settings &settings ) const;
+        void build_pathfinding_field( pathfinding_field &field ) const;
+        /**
+         * The A* search of @ref route, without its shortcuts.  Expects f and t to be in bounds.
+         * @param path_cost If not null, receives the cost of the route, which is at most
+         * settings.max_length.
+         */
+        std::vector<tripoint> route_astar( const tripoint &f, const tripoint &t,
+                                           const pathfinding_settings &settings,
+                                           const std::set<tripoint> &pre_closed,
+                                           int *path_cost ) const;
+        /**
+         * Plans a long route on the submap level with @ref pathfinding_hierarchy and refines
+         * it with @ref route_astar between the waypoints.  The cost of the whole route is
+         * limited by settings.max_length.  Empty if no such route was found.
+         */
+        std::vector<tripoint> route_hierarchical( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings, const std::set<tripoint> &pre_closed ) const;
 
         /**
          * Internal version of the drawsq. Keeps a cached maptile for less re-getting.
@@ -1995,15 +2047,19 @@ class map
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        mutable std::vector<std::unique_ptr<pathfinding_field>> pathfinding_fields;
+        mutable std::array< std::unique_ptr<pathfinding_hierarchy>, OVERMAP_LAYERS >
+        pathfinding_hierarchies;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
         std::set<tripoint> submaps_with_active_items;
 
         /**
-         * Cache of coordinate pairs recently checked for visibility.
+         * Cache of coordinate pairs recently checked for visibility, stamped with the
+         * los_generation of the level_caches involved.
          */
-        mutable lru_cache<point, char> skew_vision_cache;
+        mutable los_cache skew_vision_cache;
 
         // Note: no bounds check
         level_cache &get_cache( int zlev ) const {
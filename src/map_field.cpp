@@ -408,8 +408,6 @@ void map::process_fields_in_submap( submap *const current_submap,
 
     // Initialize the map tile wrapper
     maptile map_tile( current_submap, point_zero );
-    int &locx = map_tile.pos_.x;
-    int &locy = map_tile.pos_.y;
     const point sm_offset = sm_to_ms_copy( submap.xy() );
 
     field_proc_data pd{
@@ -422,58 +420,60 @@ void map::process_fields_in_submap( submap *const current_submap,
         &( *fd_null )
     };
 
-    // Loop through all tiles in this submap indicated by current_submap
-    for( locx = 0; locx < SEEX; locx++ ) {
-        for( locy = 0; locy < SEEY; locy++ ) {
-            // Get a reference to the field variable from the submap;
-            // contains all the pointers to the real field effects.
-            field &curfield = current_submap->get_field( {static_cast<int>( locx ), static_cast<int>( locy )} );
-
-            // when displayed_field_type == fd_null it means that `curfield` has no fields inside
-            // avoids instantiating (relatively) expensive map iterator
-            if( !curfield.displayed_field_type() ) {
-                continue;
-            }
+    // Loop through the tiles with fields. Tiles that get their first field while processing
+    // are appended to the list, their newborn fields are left alone until the next turn.
+    current_submap->update_field_tiles();
+    const size_t field_tiles = current_submap->get_field_tiles().size();
+    for( size_t i = 0; i < field_tiles; i++ ) {
+        map_tile.pos_ = current_submap->get_field_tiles()[i];
+        // Get a reference to the field variable from the submap;
+        // contains all the pointers to the real field effects.
+        field &curfield = current_submap->get_field( map_tile.pos_ );
+
+        // when displayed_field_type == fd_null it means that `curfield` has no fields inside
+        // avoids instantiating (relatively) expensive map iterator
+        if( !curfield.displayed_field_type() ) {
+            continue;
+        }
 
-            // This is a translation from local coordinates to submap coordinates.
-            const tripoint p = tripoint( map_tile.pos() + sm_offset, submap.z );
+        // This is a translation from local coordinates to submap coordinates.
+        const tripoint p = tripoint( map_tile.pos() + sm_offset, submap.z );
 
-            for( auto it = curfield.begin(); it != curfield.end(); ) {
-                // Iterating through all field effects in the submap's field.
-                field_entry &cur = it->second;
-                const int prev_intensity = cur.is_field_alive() ? cur.get_field_intensity() : 0;
+        for( auto it = curfield.begin(); it != curfield.end(); ) {
+            // Iterating through all field effects in the submap's field.
+            field_entry &cur = it->second;
+            const int prev_intensity = cur.is_field_alive() ? cur.get_field_intensity() : 0;
 
-                pd.cur_fd_type_id = cur.get_field_type();
-                pd.cur_fd_type = &( *pd.cur_fd_type_id );
+            pd.cur_fd_type_id = cur.get_field_type();
+            pd.cur_fd_type = &( *pd.cur_fd_type_id );
 
-                // The field might have been killed by processing a neighbor field
-                if( prev_intensity == 0 ) {
-                    on_field_modified( p, *pd.cur_fd_type );
-                    --current_submap->field_count;
-                    curfield.remove_field( it++ );
-                    continue;
-                }
-
-                // Don't process "newborn" fields. This gives the player time to run if they need to.
-                if( cur.get_field_age() == 0_turns ) {
-                    cur.do_decay();
-                    if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
-                        on_field_modified( p, *pd.cur_fd_type );
-                    }
-                    it++;
-                    continue;
-                }
-
-                for( const FieldProcessorPtr &proc : pd.cur_fd_type->get_processors() ) {
-                    proc( p, cur, pd );
-                }
+            // The field might have been killed by processing a neighbor field
+            if( prev_intensity == 0 ) {
+                on_field_modified( p, *pd.cur_fd_type );
+                --current_submap->field_count;
+                curfield.remove_field( it++ );
+                continue;
+            }
 
+            // Don't process "newborn" fields. This gives the player time to run if they need to.
+            if( cur.get_field_age() == 0_turns ) {
                 cur.do_decay();
                 if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
                     on_field_modified( p, *pd.cur_fd_type );
                 }
                 it++;
+                continue;
+            }
+
+            for( const FieldProcessorPtr &proc : pd.cur_fd_type->get_processors() ) {
+                proc( p, cur, pd );
+            }
+
+            cur.do_decay();
+            if( !cur.is_field_alive() || cur.get_field_intensity() != prev_intensity ) {
+                on_field_modified( p, *pd.cur_fd_type );
             }
+            it++;
         }
     }
     sblk.commit_modifications();
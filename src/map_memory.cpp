@@ -1,6 +1,7 @@
 #include "cata_assert.h"
 #include "cached_options.h"
 #include "cata_utility.h"
+#include "compression.h"
 #include "coordinate_conversions.h"
 #include "cuboid_rectangle.h"
 #include "filesystem.h"
@@ -351,7 +352,8 @@ bool map_memory::save( const tripoint &pos )
                 } );
             };
 
-            const bool res = write_to_file( path, writer, descr.c_str() );
+            const bool res = write_to_file( path, writer, descr.c_str(),
+                                             save_file_compression() );
             result = result & res;
         }
         tripoint regp_sm = mmr_to_sm_copy( regp );
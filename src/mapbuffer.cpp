@@ -1,16 +1,17 @@
 #include "mapbuffer.h"
 
-#include <chrono>
 #include <exception>
 #include <functional>
-#include <ratio>
+#include <iterator>
 #include <set>
 #include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "cached_options.h"
 #include "cata_utility.h"
+#include "compression.h"
 #include "coordinate_conversions.h"
 #include "debug.h"
 #include "filesystem.h"
@@ -18,13 +19,13 @@
 #include "game_constants.h"
 #include "json.h"
 #include "map.h"
-#include "output.h"
+#include "options.h"
 #include "path_info.h"
-#include "popup.h"
+#include "region_file.h"
 #include "string_formatter.h"
 #include "submap.h"
-#include "translations.h"
-#include "ui_manager.h"
+#include "submap_binary.h"
+#include "thread_pool.h"
 
 #define dbg(x) DebugLog((x),D_MAP) << __FILE__ << ":" << __LINE__ << ": "
 
@@ -33,6 +34,15 @@ static std::string find_quad_path( const std::string &dirname, const tripoint &o
     return string_format( "%s/%d.%d.%d.map", dirname, om_addr.x, om_addr.y, om_addr.z );
 }
 
+// Path of the file of a quad as written by old saves, where the number formatting of the locale
+// could add thousands separators: "map/1,234.7.8.map" instead of "map/1234.7.8.map"
+static std::string find_legacy_quad_path( const std::string &dirname, const tripoint &om_addr )
+{
+    std::ostringstream buffer;
+    buffer << dirname << "/" << om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
+    return buffer.str();
+}
+
 static std::string find_dirname( const tripoint &om_addr )
 {
     const tripoint segment_addr = omt_to_seg_copy( om_addr );
@@ -40,14 +50,83 @@ static std::string find_dirname( const tripoint &om_addr )
                           segment_addr.y, segment_addr.z );
 }
 
+static std::string find_region_path( const tripoint &om_addr )
+{
+    return region_file_path( PATH_INFO::world_base_save_path() + "/maps", om_addr );
+}
+
 mapbuffer MAPBUFFER;
 
 mapbuffer::mapbuffer() = default;
-mapbuffer::~mapbuffer() = default;
+
+mapbuffer::~mapbuffer()
+{
+    // Too late for debugmsg, game::save already reported the errors of any save it waited for
+    if( save_thread.joinable() ) {
+        save_thread.join();
+    }
+    if( !save_error.empty() ) {
+        DebugLog( D_ERROR, D_MAP ) << "Failed to save the maps: " << save_error;
+    }
+    if( prefetch_thread.joinable() ) {
+        prefetch_thread.join();
+    }
+}
 
 void mapbuffer::clear()
 {
+    wait_for_pending_save();
+    finish_prefetch();
+    prefetched_quads.clear();
+    unsaved_quads.clear();
     submaps.clear();
+    saved_quad_hashes.clear();
+    open_regions.clear();
+}
+
+void mapbuffer::close_region_files()
+{
+    open_regions.clear();
+}
+
+region_file &mapbuffer::get_region( const std::string &path )
+{
+    auto it = open_regions.find( path );
+    if( it == open_regions.end() ) {
+        // Each one keeps a file open, so don't keep too many
+        if( open_regions.size() >= 16 ) {
+            open_regions.clear();
+        }
+        it = open_regions.emplace( path, region_file( path ) ).first;
+    }
+    return it->second;
+}
+
+bool mapbuffer::wait_for_pending_save()
+{
+    if( save_thread.joinable() ) {
+        save_thread.join();
+    }
+    // Their files changed under the open ones
+    for( const std::string &region_path : regions_being_saved ) {
+        open_regions.erase( region_path );
+    }
+    regions_being_saved.clear();
+    if( !save_error.empty() ) {
+        debugmsg( "Failed to save the maps: %s", save_error );
+        save_error.clear();
+        // Some of the quads might not have been written, so write all of them next time
+        saved_quad_hashes.clear();
+        return false;
+    }
+    return true;
+}
+
+void mapbuffer::report_finished_save()
+{
+    if( save_thread.joinable() && save_finished ) {
+        wait_for_pending_save();
+    }
 }
 
 bool mapbuffer::add_submap( const tripoint &p, std::unique_ptr<submap> &sm )
@@ -100,35 +179,139 @@ submap *mapbuffer::lookup_submap( const tripoint &p )
     return iter->second.get();
 }
 
+void mapbuffer::prefetch( const std::vector<tripoint> &submap_positions )
+{
+    finish_prefetch();
+
+    std::set<tripoint> wanted;
+    for( const tripoint &p : submap_positions ) {
+        if( submaps.count( p ) == 0 ) {
+            wanted.insert( sm_to_omt_copy( p ) );
+        }
+    }
+    for( auto it = prefetched_quads.begin(); it != prefetched_quads.end(); ) {
+        if( wanted.erase( it->first ) != 0 ) {
+            ++it;
+        } else {
+            it = prefetched_quads.erase( it );
+        }
+    }
+    for( auto it = unsaved_quads.begin(); it != unsaved_quads.end(); ) {
+        if( wanted.erase( *it ) != 0 ) {
+            ++it;
+        } else {
+            it = unsaved_quads.erase( it );
+        }
+    }
+    for( auto it = wanted.begin(); it != wanted.end(); ) {
+        if( regions_being_saved.count( find_region_path( *it ) ) != 0 ) {
+            // Its region file is not in a consistent state until the save is done
+            it = wanted.erase( it );
+        } else {
+            ++it;
+        }
+    }
+    if( wanted.empty() ) {
+        return;
+    }
+
+    // Loading the submaps touches lots of global state, so only the file is read here
+    quads_being_prefetched = wanted;
+    const std::string maps_dir = PATH_INFO::world_base_save_path() + "/maps";
+    // Files of single quads take precedence over the region file, see unserialize_submaps
+    std::map<tripoint, std::pair<std::string, std::string>> quad_files;
+    for( const tripoint &om_addr : wanted ) {
+        const std::string dirname = find_dirname( om_addr );
+        quad_files.emplace( om_addr, std::make_pair( find_quad_path( dirname, om_addr ),
+                            find_legacy_quad_path( dirname, om_addr ) ) );
+    }
+    prefetch_thread = std::thread( [this, maps_dir, quad_files]() {
+        // Several quads of a region are read through one open file
+        std::map<std::string, region_file> regions;
+        for( const auto &quad_file : quad_files ) {
+            const tripoint &om_addr = quad_file.first;
+            if( file_exist( quad_file.second.first ) || file_exist( quad_file.second.second ) ) {
+                // Loaded from that file the usual way
+                continue;
+            }
+            try {
+                const std::string region_path = region_file_path( maps_dir, om_addr );
+                const region_file &region = regions.emplace( region_path,
+                                            region_file( region_path ) ).first->second;
+                std::string data;
+                if( region.read( region_quad_position( om_addr ), data ) ) {
+                    prefetch_results.emplace( om_addr, std::move( data ) );
+                } else {
+                    prefetch_misses.insert( om_addr );
+                }
+            } catch( const std::exception & ) {
+                // Reported when it is loaded the usual way
+            }
+        }
+    } );
+}
+
+void mapbuffer::finish_prefetch()
+{
+    if( prefetch_thread.joinable() ) {
+        prefetch_thread.join();
+    }
+    quads_being_prefetched.clear();
+    for( std::pair<const tripoint, std::string> &result : prefetch_results ) {
+        prefetched_quads[result.first] = std::move( result.second );
+    }
+    prefetch_results.clear();
+    unsaved_quads.insert( prefetch_misses.begin(), prefetch_misses.end() );
+    prefetch_misses.clear();
+}
+
+// Contents of the file of a quad, called from the thread pool
+static std::string serialize_quad( const std::vector<std::pair<tripoint, const submap *>>
+                                   &quad_submaps, const bool binary )
+{
+    if( binary ) {
+        return submaps_to_binary( quad_submaps );
+    }
+    std::ostringstream fout;
+    JsonOut jsout( fout );
+    jsout.start_array();
+    for( const std::pair<tripoint, const submap *> &quad_submap : quad_submaps ) {
+        jsout.start_object();
+
+        jsout.member( "version", savegame_version );
+        jsout.member( "coordinates" );
+
+        jsout.start_array();
+        jsout.write( quad_submap.first.x );
+        jsout.write( quad_submap.first.y );
+        jsout.write( quad_submap.first.z );
+        jsout.end_array();
+
+        quad_submap.second->store( jsout );
+
+        jsout.end_object();
+    }
+    jsout.end_array();
+    return fout.str();
+}
+
 void mapbuffer::save( bool delete_after_save )
 {
+    // Only one batch is written at a time, and not while quads are read in advance
+    wait_for_pending_save();
+    finish_prefetch();
     assure_dir_exist( PATH_INFO::world_base_save_path() + "/maps" );
 
-    int num_saved_submaps = 0;
-    int num_total_submaps = submaps.size();
-
     map &here = get_map();
     const tripoint map_origin = sm_to_omt_copy( here.get_abs_sub() );
     const bool map_has_zlevels = g != nullptr && here.has_zlevels();
 
-    static_popup popup;
-
     // A set of already-saved submaps, in global overmap coordinates.
     std::set<tripoint> saved_submaps;
     std::list<tripoint> submaps_to_delete;
-    static constexpr std::chrono::milliseconds update_interval( 500 );
-    auto last_update = std::chrono::steady_clock::now();
+    std::vector<quad_snapshot> quads;
 
     for( auto &elem : submaps ) {
-        auto now = std::chrono::steady_clock::now();
-        if( last_update + update_interval < now ) {
-            popup.message( _( "Please wait as the map saves [%d/%d]" ),
-                           num_saved_submaps, num_total_submaps );
-            ui_manager::redraw();
-            refresh_display();
-            inp_mngr.pump_events();
-            last_update = now;
-        }
         // Whatever the coordinates of the current submap are,
         // we're saving a 2x2 quad of submaps at a time.
         // Submaps are generated in quads, so we know if we have one member of a quad,
@@ -141,29 +324,113 @@ void mapbuffer::save( bool delete_after_save )
         saved_submaps.insert( om_addr );
 
         // A segment is a chunk of 32x32 submap quads.
-        // We're breaking them into subdirectories so there aren't too many files per directory.
-        // Might want to make a set for this one too so it's only checked once per save().
-        const std::string dirname = find_dirname( om_addr );
-        const std::string quad_path = find_quad_path( dirname, om_addr );
+        // All quads of a segment are stored in one region file.
+        const std::string region_path = find_region_path( om_addr );
 
         // delete_on_save deletes everything, otherwise delete submaps
         // outside the current map.
         const bool zlev_del = !map_has_zlevels && om_addr.z != get_map().get_abs_sub().z;
-        save_quad( dirname, quad_path, om_addr, submaps_to_delete,
-                   delete_after_save || zlev_del ||
-                   om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
-                   om_addr.x > map_origin.x + HALF_MAPSIZE ||
-                   om_addr.y > map_origin.y + HALF_MAPSIZE );
-        num_saved_submaps += 4;
+        snapshot_quad( region_path, om_addr, submaps_to_delete,
+                       delete_after_save || zlev_del ||
+                       om_addr.x < map_origin.x || om_addr.y < map_origin.y ||
+                       om_addr.x > map_origin.x + HALF_MAPSIZE ||
+                       om_addr.y > map_origin.y + HALF_MAPSIZE, quads );
+    }
+
+    // The submaps don't change until the loop is done, so the quads can be serialized at the
+    // same time
+    const bool binary = get_option<bool>( "BINARY_MAP_SAVES" );
+    std::vector<std::string> contents( quads.size() );
+    std::vector<size_t> hashes( quads.size() );
+    const auto serialize = [&]( const int i ) {
+        contents[i] = serialize_quad( quads[i].submaps, binary );
+        hashes[i] = std::hash<std::string>()( contents[i] );
+    };
+    if( thread_pool *pool = get_thread_pool( map_cache_threads ) ) {
+        pool->parallel_for( 0, static_cast<int>( quads.size() ), serialize );
+    } else {
+        for( size_t i = 0; i < quads.size(); ++i ) {
+            serialize( static_cast<int>( i ) );
+        }
+    }
+
+    // The batch only holds strings, so the game can go on while it is written
+    const bool use_regions = get_option<bool>( "REGION_MAP_SAVES" );
+    save_batch batch;
+    for( size_t i = 0; i < quads.size(); ++i ) {
+        const quad_snapshot &quad = quads[i];
+        const auto saved = saved_quad_hashes.find( quad.om_addr );
+        const bool unchanged = saved != saved_quad_hashes.end() && saved->second == hashes[i];
+        if( quad.deleted ) {
+            // Read from the file again when it is loaded, so no need to remember it
+            saved_quad_hashes.erase( quad.om_addr );
+        } else {
+            saved_quad_hashes[quad.om_addr] = hashes[i];
+        }
+        if( unchanged ) {
+            // The file already has this content
+            continue;
+        }
+        prefetched_quads.erase( quad.om_addr );
+        unsaved_quads.erase( quad.om_addr );
+        // Reads of the quad wait for the save, whichever file it goes to
+        regions_being_saved.insert( quad.region_path );
+        const std::string dirname = find_dirname( quad.om_addr );
+        const std::string quad_path = find_quad_path( dirname, quad.om_addr );
+        if( use_regions ) {
+            batch.regions[quad.region_path].emplace_back( region_quad_position( quad.om_addr ),
+                    std::move( contents[i] ) );
+            // Replaced by the region file
+            batch.old_quad_files[quad.region_path].push_back( quad_path );
+            batch.old_quad_files[quad.region_path].push_back(
+                find_legacy_quad_path( dirname, quad.om_addr ) );
+        } else {
+            batch.quad_files.emplace_back( quad_path, std::move( contents[i] ) );
+        }
     }
     for( auto &elem : submaps_to_delete ) {
         remove_submap( elem );
     }
+
+    if( batch.regions.empty() && batch.quad_files.empty() ) {
+        return;
+    }
+    const bool compress = save_file_compression() == file_compression::deflate;
+    save_finished = false;
+    save_thread = std::thread( [this, compress, batch = std::move( batch )]() mutable {
+        try {
+            for( std::pair<std::string, std::string> &quad_file : batch.quad_files ) {
+                if( compress ) {
+                    quad_file.second = compress_data( quad_file.second );
+                }
+                assure_dir_exist( quad_file.first.substr( 0, quad_file.first.rfind( '/' ) ) );
+                write_to_file( quad_file.first, [&quad_file]( std::ostream & fout ) {
+                    fout << quad_file.second;
+                } );
+            }
+            for( auto &region : batch.regions ) {
+                if( compress ) {
+                    for( std::pair<point, std::string> &quad : region.second ) {
+                        quad.second = compress_data( quad.second );
+                    }
+                }
+                region_file( region.first ).write( region.second );
+                for( const std::string &old_file : batch.old_quad_files[region.first] ) {
+                    if( file_exist( old_file ) ) {
+                        remove_file( old_file );
+                    }
+                }
+            }
+        } catch( const std::exception &err ) {
+            save_error = err.what();
+        }
+        save_finished = true;
+    } );
 }
 
-void mapbuffer::save_quad( const std::string &dirname, const std::string &filename,
-                           const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                           bool delete_after_save )
+void mapbuffer::snapshot_quad( const std::string &region_path, const tripoint &om_addr,
+                               std::list<tripoint> &submaps_to_delete, bool delete_after_save,
+                               std::vector<quad_snapshot> &quads )
 {
     std::vector<point> offsets;
     std::vector<tripoint> submap_addrs;
@@ -197,44 +464,25 @@ void mapbuffer::save_quad( const std::string &dirname, const std::string &filena
         return;
     }
 
-    // Don't create the directory if it would be empty
-    assure_dir_exist( dirname );
-    write_to_file( filename, [&]( std::ostream & fout ) {
-        JsonOut jsout( fout );
-        jsout.start_array();
-        for( auto &submap_addr : submap_addrs ) {
-            if( submaps.count( submap_addr ) == 0 ) {
-                continue;
-            }
-
-            submap *sm = submaps[submap_addr].get();
-
-            if( sm == nullptr ) {
-                continue;
-            }
-
-            jsout.start_object();
-
-            jsout.member( "version", savegame_version );
-            jsout.member( "coordinates" );
+    quad_snapshot quad{ om_addr, region_path, {}, delete_after_save };
+    for( auto &submap_addr : submap_addrs ) {
+        if( submaps.count( submap_addr ) == 0 ) {
+            continue;
+        }
 
-            jsout.start_array();
-            jsout.write( submap_addr.x );
-            jsout.write( submap_addr.y );
-            jsout.write( submap_addr.z );
-            jsout.end_array();
+        submap *sm = submaps[submap_addr].get();
 
-            sm->store( jsout );
+        if( sm == nullptr ) {
+            continue;
+        }
 
-            jsout.end_object();
+        quad.submaps.emplace_back( submap_addr, sm );
 
-            if( delete_after_save ) {
-                submaps_to_delete.push_back( submap_addr );
-            }
+        if( delete_after_save ) {
+            submaps_to_delete.push_back( submap_addr );
         }
-
-        jsout.end_array();
-    } );
+    }
+    quads.push_back( std::move( quad ) );
 }
 
 // We're reading in way too many entities here to mess around with creating sub-objects and
@@ -246,20 +494,52 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     const std::string dirname = find_dirname( om_addr );
     std::string quad_path = find_quad_path( dirname, om_addr );
 
-    if( !file_exist( quad_path ) ) {
-        // Fix for old saves where the path was generated using std::stringstream, which
-        // did format the number using the current locale. That formatting may insert
-        // thousands separators, so the resulting path is "map/1,234.7.8.map" instead
-        // of "map/1234.7.8.map".
-        std::ostringstream buffer;
-        buffer << dirname << "/" << om_addr.x << "." << om_addr.y << "." << om_addr.z << ".map";
-        if( file_exist( buffer.str() ) ) {
-            quad_path = buffer.str();
+    const std::string region_path = find_region_path( om_addr );
+    if( quads_being_prefetched.count( om_addr ) != 0 ) {
+        // It will be read soon, which is still faster than reading it again
+        finish_prefetch();
+    }
+    std::string region_data;
+    bool in_region = false;
+    const auto prefetched = prefetched_quads.find( om_addr );
+    if( prefetched != prefetched_quads.end() ) {
+        region_data = std::move( prefetched->second );
+        prefetched_quads.erase( prefetched );
+        in_region = true;
+    } else {
+        if( regions_being_saved.count( region_path ) != 0 ) {
+            // The file might be half written
+            wait_for_pending_save();
+        }
+        if( !file_exist( quad_path ) ) {
+            // Fix for old saves where the path was generated using std::stringstream, see
+            // find_legacy_quad_path
+            const std::string legacy_path = find_legacy_quad_path( dirname, om_addr );
+            if( file_exist( legacy_path ) ) {
+                quad_path = legacy_path;
+            }
         }
+        // Files of single quads are only written by saves without region files, and saving a
+        // quad to its region file removes them, so such a file is always the newer one.
+        // A prefetch might already have found that it is not in its region file.
+        in_region = !file_exist( quad_path ) && unsaved_quads.count( om_addr ) == 0 &&
+                    get_region( region_path ).read( region_quad_position( om_addr ), region_data );
+    }
+    if( in_region ) {
+        std::istringstream fin( region_data );
+        deserialize_quad( fin, region_path );
+        if( submaps.count( p ) == 0 ) {
+            debugmsg( "region %s did not contain the expected submap %d,%d,%d",
+                      region_path, p.x, p.y, p.z );
+            return nullptr;
+        }
+        return submaps[ p ].get();
     }
 
-    using namespace std::placeholders;
-    if( !read_from_file_optional_json( quad_path, std::bind( &mapbuffer::deserialize, this, _1 ) ) ) {
+    const bool loaded = read_from_file_optional( quad_path, [&]( std::istream & fin ) {
+        deserialize_quad( fin, quad_path );
+    } );
+    if( !loaded ) {
         // If it doesn't exist, trigger generating it.
         return nullptr;
     }
@@ -271,6 +551,32 @@ submap *mapbuffer::unserialize_submaps( const tripoint &p )
     return submaps[ p ].get();
 }
 
+void mapbuffer::deserialize_quad( std::istream &fin, const std::string &path )
+{
+    std::string contents( submap_binary_magic.size(), '\0' );
+    fin.read( &contents[0], contents.size() );
+    contents.resize( fin.gcount() );
+    if( is_compressed_data( contents ) ) {
+        // Quads in region files are compressed on their own, see save()
+        contents.append( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+        std::istringstream decompressed( decompress_data( contents ) );
+        deserialize_quad( decompressed, path );
+    } else if( is_binary_submap_data( contents ) ) {
+        contents.append( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+        submaps_from_binary( contents, [this]( const tripoint & pos, std::unique_ptr<submap> &sm ) {
+            if( !add_submap( pos, sm ) ) {
+                debugmsg( "submap %d,%d,%d was already loaded", pos.x, pos.y, pos.z );
+            }
+        } );
+    } else {
+        // Saved before the binary format was introduced
+        fin.clear();
+        fin.seekg( 0 );
+        JsonIn jsin( fin, path );
+        deserialize( jsin );
+    }
+}
+
 void mapbuffer::deserialize( JsonIn &jsin )
 {
     jsin.start_array();
@@ -2,12 +2,25 @@
 #ifndef CATA_SRC_MAPBUFFER_H
 #define CATA_SRC_MAPBUFFER_H
 
+#include <atomic>
+#include <cstddef>
 #include <iosfwd>
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
 
 #include "point.h"
+#include "region_file.h"
 
 class JsonIn;
 class submap;
@@ -22,13 +35,30 @@ class mapbuffer
         ~mapbuffer();
 
         /** Store all submaps in this instance into savefiles.
+         * The submaps are serialized right away, spread over the thread pool, but the files are
+         * written by a background thread. The next save waits for them, as do @ref clear and
+         * @ref wait_for_pending_save.
          * @param delete_after_save If true, the saved submaps are removed
          * from the mapbuffer (and deleted).
          **/
         void save( bool delete_after_save = false );
 
-        /** Delete all buffered submaps. **/
+        /**
+         * Waits until the files of the last @ref save have been written.
+         * Failures to write them are reported with debugmsg.
+         * @return false if some of the files could not be written.
+         */
+        bool wait_for_pending_save();
+        /**
+         * Reports failures to write the files of the last @ref save, if they have been written.
+         * Does not wait for them, so it can be called every turn.
+         */
+        void report_finished_save();
+
+        /** Delete all buffered submaps. Waits for the last save to finish. **/
         void clear();
+        /** Closes the region files kept open for reading, so they can be deleted. */
+        void close_region_files();
 
         /** Add a new submap to the buffer.
          *
@@ -54,6 +84,17 @@ class mapbuffer
          */
         submap *lookup_submap( const tripoint &p );
 
+        /**
+         * Starts reading the saved quads of the given submaps from disk on a background thread,
+         * so that looking them up later does not have to wait for it. Submaps that were never
+         * saved are still generated when they are looked up.
+         * Quads read by earlier calls that are not requested again are dropped.
+         * @param submap_positions Absolute positions in submap coordinates.
+         */
+        void prefetch( const std::vector<tripoint> &submap_positions );
+        /** Waits until the quads requested by the last @ref prefetch have been read. */
+        void finish_prefetch();
+
     private:
         using submap_map_t = std::map<tripoint, std::unique_ptr<submap>>;
 
@@ -70,11 +111,64 @@ class mapbuffer
         // if not handled carefully, this can erase in-use submaps and crash the game.
         void remove_submap( tripoint addr );
         submap *unserialize_submaps( const tripoint &p );
+        /** Loads a quad in either the binary or the (older) JSON format, possibly compressed. */
+        void deserialize_quad( std::istream &fin, const std::string &path );
         void deserialize( JsonIn &jsin );
-        void save_quad( const std::string &dirname, const std::string &filename,
-                        const tripoint &om_addr, std::list<tripoint> &submaps_to_delete,
-                        bool delete_after_save );
+
+        /** The submaps of a quad that @ref save serializes. */
+        struct quad_snapshot {
+            tripoint om_addr;
+            std::string region_path;
+            std::vector<std::pair<tripoint, const submap *>> submaps;
+            // Whether the submaps are removed from the buffer after the save
+            bool deleted;
+        };
+        void snapshot_quad( const std::string &region_path, const tripoint &om_addr,
+                            std::list<tripoint> &submaps_to_delete, bool delete_after_save,
+                            std::vector<quad_snapshot> &quads );
         submap_map_t submaps;
+
+        /** What @ref save_thread writes, depending on the REGION_MAP_SAVES world option. */
+        struct save_batch {
+            /** Quads by the region file they go to. */
+            std::map<std::string, std::vector<std::pair<point, std::string>>> regions;
+            /** Files of single quads in the region files, removed once it is written. */
+            std::map<std::string, std::vector<std::string>> old_quad_files;
+            /** Paths and contents of files of single quads, if region files are not used. */
+            std::vector<std::pair<std::string, std::string>> quad_files;
+        };
+        /** Writes the batch of the last save, joined by @ref wait_for_pending_save. */
+        std::thread save_thread;
+        /** Set by @ref save_thread when it is done, so it can be joined without waiting. */
+        std::atomic<bool> save_finished{ false };
+        /** Region files that @ref save_thread is writing, or the regions of the quad files. */
+        std::set<std::string> regions_being_saved;
+        /** Region files kept open for reading quads, closed once a save writes them. */
+        std::map<std::string, region_file> open_regions;
+        region_file &get_region( const std::string &path );
+        /** Set by @ref save_thread if writing failed. */
+        std::string save_error;
+        /**
+         * Hashes of the contents of the quad files as of the last save, so quads that did not
+         * change are not written again. Only kept for quads that are still in the buffer.
+         */
+        std::unordered_map<tripoint, size_t> saved_quad_hashes;
+
+        /** Reads the quads requested by the last @ref prefetch. */
+        std::thread prefetch_thread;
+        /** Quads @ref prefetch_thread is reading, by overmap terrain position. */
+        std::set<tripoint> quads_being_prefetched;
+        /** Written by @ref prefetch_thread only, until it is joined. */
+        std::map<tripoint, std::string> prefetch_results;
+        /** Requested quads that are not saved, written by @ref prefetch_thread like the results. */
+        std::set<tripoint> prefetch_misses;
+        /** Contents of quads that have been read in advance, as stored in their region file. */
+        std::map<tripoint, std::string> prefetched_quads;
+        /**
+         * Quads that an earlier @ref prefetch did not find in their region file, so they are not
+         * looked for again until they are saved.
+         */
+        std::set<tripoint> unsaved_quads;
 };
 
 extern mapbuffer MAPBUFFER;
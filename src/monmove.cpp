@@ -10,6 +10,7 @@
 #include <list>
 #include <memory>
 #include <ostream>
+#include <set>
 #include <string>
 #include <unordered_map>
 
@@ -37,6 +38,7 @@
 #include "monster_oracle.h"
 #include "mtype.h"
 #include "npc.h"
+#include "optional.h"
 #include "pathfinding.h"
 #include "pimpl.h"
 #include "player.h"
@@ -371,7 +373,15 @@ void monster::plan()
             }
         }
         if( angers_cub_threatened > 0 ) {
-            for( monster &tmp : g->all_monsters() ) {
+            // Babies rate the player by distance, divided by the player's power rating for smart
+            // planning, so babies further away than this cannot rate the player below dist
+            const float reach = smart_planning ?
+                                dist * std::max( player_character.power_rating(), 1.0f ) : dist;
+            const int radius = static_cast<int>( std::min( std::ceil( reach ),
+                                                 static_cast<float>( MAX_VIEW_DISTANCE ) ) );
+            for( monster *baby : g->critter_tracker->find_in_radius( player_character.pos(),
+                    radius ) ) {
+                monster &tmp = *baby;
                 if( type->baby_monster == tmp.type->id ) {
                     // baby nearby; is the player too close?
                     dist = tmp.rate_target( player_character, dist, smart_planning );
@@ -384,11 +394,13 @@ void monster::plan()
             }
         }
     } else if( friendly != 0 && !docile ) {
-        for( monster &tmp : g->all_monsters() ) {
-            if( tmp.friendly == 0 && seen_levels.test( tmp.pos().z + OVERMAP_DEPTH ) ) {
-                float rating = rate_target( tmp, dist, smart_planning );
+        // Nothing further away than our sight range gets a rating
+        for( monster *tmp : g->critter_tracker->find_in_radius( pos(),
+                std::max( max_sight_range, 1 ) ) ) {
+            if( tmp->friendly == 0 && seen_levels.test( tmp->pos().z + OVERMAP_DEPTH ) ) {
+                float rating = rate_target( *tmp, dist, smart_planning );
                 if( rating < dist ) {
-                    target = &tmp;
+                    target = tmp;
                     dist = rating;
                 }
             }
@@ -469,46 +481,39 @@ void monster::plan()
                                turns_since_target );
     int turns_to_skip = max_turns_to_skip * rate_limiting_factor;
     if( friendly == 0 && ( turns_to_skip == 0 || turns_since_target % turns_to_skip == 0 ) ) {
-        for( const auto &fac_list : factions ) {
-            mf_attitude faction_att = faction.obj().attitude( fac_list.first );
+        // Nothing further away than our sight range gets a rating
+        for( monster *tmp : g->critter_tracker->find_in_radius( pos(),
+                std::max( max_sight_range, 1 ) ) ) {
+            mf_attitude faction_att = faction.obj().attitude( tmp->faction );
             if( faction_att == MFA_NEUTRAL || faction_att == MFA_FRIENDLY ) {
                 continue;
             }
-
-            for( const auto &fac : fac_list.second ) {
-                if( !seen_levels.test( fac.first + OVERMAP_DEPTH ) ) {
-                    continue;
-                }
-                for( const weak_ptr_fast<monster> &weak : fac.second ) {
-                    const shared_ptr_fast<monster> shared = weak.lock();
-                    if( !shared ) {
-                        continue;
-                    }
-                    monster &mon = *shared;
-                    float rating = rate_target( mon, dist, smart_planning );
-                    if( rating == dist ) {
-                        ++valid_targets;
-                        if( one_in( valid_targets ) ) {
-                            target = &mon;
-                        }
-                    }
-                    if( rating < dist ) {
-                        target = &mon;
-                        dist = rating;
-                        valid_targets = 1;
-                    }
-                    if( rating <= 5 ) {
-                        anger += angers_hostile_near;
-                        morale -= fears_hostile_near;
-                    }
-                    if( !fleeing && anger <= 20 && valid_targets != 0 ) {
-                        anger += angers_hostile_seen;
-                    }
-                    if( !fleeing && valid_targets != 0 ) {
-                        morale -= fears_hostile_seen;
-                    }
+            if( !seen_levels.test( tmp->pos().z + OVERMAP_DEPTH ) ) {
+                continue;
+            }
+            monster &mon = *tmp;
+            float rating = rate_target( mon, dist, smart_planning );
+            if( rating == dist ) {
+                ++valid_targets;
+                if( one_in( valid_targets ) ) {
+                    target = &mon;
                 }
             }
+            if( rating < dist ) {
+                target = &mon;
+                dist = rating;
+                valid_targets = 1;
+            }
+            if( rating <= 5 ) {
+                anger += angers_hostile_near;
+                morale -= fears_hostile_near;
+            }
+            if( !fleeing && anger <= 20 && valid_targets != 0 ) {
+                anger += angers_hostile_seen;
+            }
+            if( !fleeing && valid_targets != 0 ) {
+                morale -= fears_hostile_seen;
+            }
         }
     }
     if( target == nullptr ) {
@@ -879,14 +884,28 @@ void monster::move()
             }
 
             const auto &pf_settings = get_pathfinding_settings();
+            cata::optional<tripoint> shared_step;
             if( pf_settings.max_dist >= rl_dist( pos(), goal ) &&
                 ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != goal ) ) {
                 // We need a new path
-                path = here.route( pos(), goal, pf_settings, get_path_avoid() );
+                // Monsters converging on the same goal share a single distance field
+                const std::set<tripoint> path_avoid = get_path_avoid();
+                if( path_avoid.empty() ) {
+                    shared_step = here.shared_route_step( pos(), goal, pf_settings );
+                }
+                if( shared_step ) {
+                    path.clear();
+                } else {
+                    path = here.route( pos(), goal, pf_settings, path_avoid );
+                }
             }
 
-            // Try to respect old paths, even if we can't pathfind at the moment
-            if( !path.empty() && path.back() == goal ) {
+            if( shared_step ) {
+                destination = *shared_step;
+                moved = true;
+                pathed = true;
+            } else if( !path.empty() && path.back() == goal ) {
+                // Try to respect old paths, even if we can't pathfind at the moment
                 destination = path.front();
                 moved = true;
                 pathed = true;
@@ -16,6 +16,7 @@
 #include "colony.h"
 #include "coordinate_conversions.h"
 #include "coordinates.h"
+#include "creature_tracker.h"
 #include "cursesdef.h"
 #include "debug.h"
 #include "effect.h"
@@ -264,7 +265,8 @@ void monster::poly( const mtype_id &id )
 
 bool monster::can_upgrade() const
 {
-    return upgrades && get_option<float>( "MONSTER_UPGRADE_FACTOR" ) > 0.0;
+    static const option_handle<float> monster_upgrade_factor( "MONSTER_UPGRADE_FACTOR" );
+    return upgrades && monster_upgrade_factor.value() > 0.0;
 }
 
 // For master special attack.
@@ -2491,14 +2493,15 @@ void monster::die( Creature *nkiller )
 
     if( anger_adjust != 0 || morale_adjust != 0 ) {
         int light = g->light_level( posz() );
-        for( monster &critter : g->all_monsters() ) {
-            if( !critter.type->same_species( *type ) ) {
+        // Nobody further away than the light level can see us
+        for( monster *critter : g->critter_tracker->find_in_radius( pos(), light ) ) {
+            if( !critter->type->same_species( *type ) ) {
                 continue;
             }
 
-            if( here.sees( critter.pos(), pos(), light ) ) {
-                critter.morale += morale_adjust;
-                critter.anger += anger_adjust;
+            if( here.sees( critter->pos(), pos(), light ) ) {
+                critter->morale += morale_adjust;
+                critter->anger += anger_adjust;
             }
         }
     }
@@ -2943,14 +2946,15 @@ void monster::on_hit( Creature *source, bodypart_id,
     if( anger_adjust != 0 || morale_adjust != 0 ) {
         int light = g->light_level( posz() );
         map &here = get_map();
-        for( monster &critter : g->all_monsters() ) {
-            if( !critter.type->same_species( *type ) ) {
+        // Nobody further away than the light level can see us
+        for( monster *critter : g->critter_tracker->find_in_radius( pos(), light ) ) {
+            if( !critter->type->same_species( *type ) ) {
                 continue;
             }
 
-            if( here.sees( critter.pos(), pos(), light ) ) {
-                critter.morale += morale_adjust;
-                critter.anger += anger_adjust;
+            if( here.sees( critter->pos(), pos(), light ) ) {
+                critter->morale += morale_adjust;
+                critter->anger += anger_adjust;
             }
         }
     }
@@ -1,10 +1,12 @@
 #include "options.h"
 
+#include <atomic>
 #include <clocale>
 #include <cfloat>
 #include <climits>
 #include <clocale>
 #include <iterator>
+#include <mutex>
 #include <new>
 #include <stdexcept>
 
@@ -34,6 +36,7 @@
 #include "string_input_popup.h"
 #include "translations.h"
 #include "try_parse_integer.h"
+#include "turn_profiler.h"
 #include "ui_manager.h"
 #include "worldfactory.h"
 
@@ -54,6 +57,44 @@
 std::map<std::string, std::string> TILESETS; // All found tilesets: <name, tileset_dir>
 std::map<std::string, std::string> SOUNDPACKS; // All found soundpacks: <name, soundpack_dir>
 
+// Changes whenever an option may have changed, read by option_handle from any thread
+static std::atomic<int> value_generation( 0 );
+
+struct option_handle_base::refresh_state {
+    std::mutex mutex;
+    // Generation of the options the value was looked up in
+    std::atomic<int> generation{ -1 };
+    // Generation the value is being looked up in, while the mutex is held
+    int refreshing = -1;
+};
+
+option_handle_base::option_handle_base( const std::string &name ) :
+    name( name ), state( std::make_unique<refresh_state>() ) {}
+
+option_handle_base::~option_handle_base() = default;
+
+bool option_handle_base::begin_refresh() const
+{
+    const int current = value_generation.load( std::memory_order_acquire );
+    if( state->generation.load( std::memory_order_acquire ) == current ) {
+        return false;
+    }
+    state->mutex.lock();
+    // Another thread may have updated the value while this one waited
+    if( state->generation.load( std::memory_order_relaxed ) == current ) {
+        state->mutex.unlock();
+        return false;
+    }
+    state->refreshing = current;
+    return true;
+}
+
+void option_handle_base::end_refresh() const
+{
+    state->generation.store( state->refreshing, std::memory_order_release );
+    state->mutex.unlock();
+}
+
 options_manager &get_options()
 {
     static options_manager single_instance;
@@ -734,6 +775,7 @@ int options_manager::cOpt::getMaxLength() const
 //set to next item
 void options_manager::cOpt::setNext()
 {
+    ++value_generation;
     if( sType == "string_select" ) {
         int iNext = getItemPos( sSet ) + 1;
         if( iNext >= static_cast<int>( vItems.size() ) ) {
@@ -777,6 +819,7 @@ void options_manager::cOpt::setNext()
 //set to previous item
 void options_manager::cOpt::setPrev()
 {
+    ++value_generation;
     if( sType == "string_select" ) {
         int iPrev = static_cast<int>( getItemPos( sSet ) ) - 1;
         if( iPrev < 0 ) {
@@ -819,6 +862,7 @@ void options_manager::cOpt::setValue( float fSetIn )
         debugmsg( "tried to set a float value to a %s option", sType );
         return;
     }
+    ++value_generation;
     fSet = fSetIn;
     if( fSet < fMin || fSet > fMax ) {
         fSet = fDefault;
@@ -832,6 +876,7 @@ void options_manager::cOpt::setValue( int iSetIn )
         debugmsg( "tried to set an int value to a %s option", sType );
         return;
     }
+    ++value_generation;
     iSet = iSetIn;
     if( iSet < iMin || iSet > iMax ) {
         iSet = iDefault;
@@ -841,6 +886,7 @@ void options_manager::cOpt::setValue( int iSetIn )
 //set value
 void options_manager::cOpt::setValue( const std::string &sSetIn )
 {
+    ++value_generation;
     if( sType == "string_select" ) {
         if( getItemPos( sSetIn ) != -1 ) {
             sSet = sSetIn;
@@ -1116,6 +1162,7 @@ void options_manager::Page::removeRepeatedEmptyLines()
 
 void options_manager::init()
 {
+    ++value_generation;
     options.clear();
     for( Page &p : pages_ ) {
         p.items_.clear();
@@ -2216,6 +2263,23 @@ void options_manager::add_options_world_default()
     { { "any", to_translation( "Any" ) }, { "multi_pool", to_translation( "Multi-pool only" ) }, { "no_freeform", to_translation( "No freeform" ) } },
     "any"
        );
+
+    add_empty_line();
+
+    add( "COMPRESS_SAVES", "world_default", to_translation( "Compress save files" ),
+         to_translation( "If true, the map, the overmaps and the character are compressed when saving.  Saves take several times less disk space and are often faster to load from slow disks.  Files saved before changing this are still read." ),
+         false
+       );
+
+    add( "BINARY_MAP_SAVES", "world_default", to_translation( "Binary map saves" ),
+         to_translation( "If true, the map is saved in a compact binary format instead of JSON.  Saving and loading the map is faster, but versions of the game from before this option can not load it.  Maps saved in either format are still read." ),
+         false
+       );
+
+    add( "REGION_MAP_SAVES", "world_default", to_translation( "Map region files" ),
+         to_translation( "If true, the map quads of each segment are saved together in one region file instead of one file per quad.  Saving and loading the map touches far fewer files, but versions of the game from before this option can not load maps saved this way.  Maps saved either way are still read, and files of single quads are moved into the region file as their quads are saved again." ),
+         false
+       );
 }
 
 void options_manager::add_options_debug()
@@ -2288,6 +2352,21 @@ void options_manager::add_options_debug()
 
     get_option( "FOV_3D_Z_RANGE" ).setPrerequisite( "FOV_3D" );
 
+    add( "MAP_CACHE_THREADS", "debug", to_translation( "Map cache threads" ),
+         to_translation( "Number of threads used to rebuild the map caches of the z-levels.  1 rebuilds them on the main thread.  More threads mostly help with z-levels enabled, when many levels change at once." ),
+         1, 16, 1
+       );
+
+    add( "DATA_LOADING_THREADS", "debug", to_translation( "Data loading threads" ),
+         to_translation( "Number of threads used to read and parse the game data files.  The parsed data is always loaded on the main thread, in the same order." ),
+         1, 16, 4
+       );
+
+    add( "DATA_CACHE", "debug", to_translation( "Skip checks of unchanged game data" ),
+         to_translation( "If true, the game remembers in the user directory which game data passed the consistency checks, and skips the checks when it loads the same data again.  The data itself is still loaded every time.  Data is checked again whenever a data file changes." ),
+         false
+       );
+
     add( "ENCODING_CONV", "debug", to_translation( "Experimental path name encoding conversion" ),
          to_translation( "If true, file path names are going to be transcoded from system encoding to UTF-8 when reading and will be transcoded back when writing.  Mainly for CJK Windows users." ),
          true
@@ -3044,6 +3123,7 @@ std::string options_manager::show( bool ingame, const bool world_options_only,
             if( ingame && world_options_changed ) {
                 ACTIVE_WORLD_OPTIONS = WOPTIONS_OLD;
             }
+            ++value_generation;
         }
     }
 
@@ -3148,6 +3228,8 @@ static void update_options_cache()
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d = ::get_option<bool>( "FOV_3D" );
     fov_3d_z_range = ::get_option<int>( "FOV_3D_Z_RANGE" );
+    map_cache_threads = ::get_option<int>( "MAP_CACHE_THREADS" );
+    data_loading_threads = ::get_option<int>( "DATA_LOADING_THREADS" );
     keycode_mode = ::get_option<std::string>( "SDL_KEYBOARD_MODE" ) == "keycode";
 }
 
@@ -3187,6 +3269,7 @@ bool options_manager::has_option( const std::string &name ) const
 
 options_manager::cOpt &options_manager::get_option( const std::string &name )
 {
+    turn_profiler::count_option_lookup();
     std::unordered_map<std::string, cOpt>::iterator opt = options.find( name );
     if( opt == options.end() ) {
         debugmsg( "requested non-existing option %s", name );
@@ -3222,6 +3305,7 @@ options_manager::options_container options_manager::get_world_defaults() const
 
 void options_manager::set_world_options( options_container *options )
 {
+    ++value_generation;
     if( options == nullptr ) {
         world_options.reset();
     } else {
@@ -6,6 +6,7 @@
 #include <functional>
 #include <iosfwd>
 #include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -324,4 +325,52 @@ inline T get_option( const std::string &name )
     return get_options().get_option( name ).value_as<T>();
 }
 
+/** Keeps track of when an @ref option_handle has to look its option up again. */
+class option_handle_base
+{
+    protected:
+        explicit option_handle_base( const std::string &name );
+        ~option_handle_base();
+
+        /**
+         * Whether the cached value has to be looked up again. If so, a lock is held until
+         * @ref end_refresh, so only one thread updates the value.
+         */
+        bool begin_refresh() const;
+        void end_refresh() const;
+
+        std::string name;
+
+    private:
+        struct refresh_state;
+        std::unique_ptr<refresh_state> state;
+};
+
+/**
+ * Value of an option that is read every turn or every frame, without looking the option up
+ * by name each time like @ref get_option does.
+ * The value is only looked up again after options changed, which includes loading another
+ * world and changing world options.
+ *
+ * The value can be read from any thread, the first reader after options changed updates it.
+ * So options must not change while other threads may hold the value.
+ */
+template<typename T>
+class option_handle : private option_handle_base
+{
+    public:
+        explicit option_handle( const std::string &name ) : option_handle_base( name ) {}
+
+        const T &value() const {
+            if( begin_refresh() ) {
+                cached = get_option<T>( name );
+                end_refresh();
+            }
+            return cached;
+        }
+
+    private:
+        mutable T cached = T();
+};
+
 #endif // CATA_SRC_OPTIONS_H
@@ -69,6 +69,11 @@ static const efftype_id effect_got_checked( "got_checked" );
 static const flag_id json_flag_THERMOMETER( "THERMOMETER" );
 static const flag_id json_flag_SPLINT( "SPLINT" );
 
+static const option_handle<bool> autosafemode( "AUTOSAFEMODE" );
+static const option_handle<int> autosafemode_turns( "AUTOSAFEMODETURNS" );
+static const option_handle<std::string> morale_style( "MORALE_STYLE" );
+static const option_handle<std::string> sidebar_position( "SIDEBAR_POSITION" );
+
 // constructor
 window_panel::window_panel(
     const std::function<void( avatar &, const catacurses::window & )> &draw_func,
@@ -868,8 +873,8 @@ static std::pair<nc_color, std::string> mana_stat( const player &u )
 static nc_color safe_color()
 {
     nc_color s_color = g->safe_mode ? c_green : c_red;
-    if( g->safe_mode == SAFE_MODE_OFF && get_option<bool>( "AUTOSAFEMODE" ) ) {
-        time_duration s_return = time_duration::from_turns( get_option<int>( "AUTOSAFEMODETURNS" ) );
+    if( g->safe_mode == SAFE_MODE_OFF && autosafemode.value() ) {
+        time_duration s_return = time_duration::from_turns( autosafemode_turns.value() );
         int iPercent = g->turnssincelastmon * 100 / s_return;
         if( iPercent >= 100 ) {
             s_color = c_green;
@@ -972,12 +977,12 @@ static void draw_limb2( avatar &u, const catacurses::window &w )
 
     // print mood
     std::pair<nc_color, int> morale_pair = morale_stat( u );
-    bool m_style = get_option<std::string>( "MORALE_STYLE" ) == "horizontal";
+    bool m_style = morale_style.value() == "horizontal";
     std::string smiley = morale_emotion( morale_pair.second, get_face_type( u ), m_style );
 
     // print safe mode
     std::string safe_str;
-    if( g->safe_mode || get_option<bool>( "AUTOSAFEMODE" ) ) {
+    if( g->safe_mode || autosafemode.value() ) {
         safe_str = _( "SAFE" );
     }
     mvwprintz( w, point( 22, 2 ), safe_color(), safe_str );
@@ -1283,7 +1288,7 @@ static void draw_char_narrow( avatar &u, const catacurses::window &w )
     nc_color move_color =  move_mode_color( u );
     char move_char = move_mode_string( u );
     std::string movecost = std::to_string( u.movecounter ) + "(" + move_char + ")";
-    bool m_style = get_option<std::string>( "MORALE_STYLE" ) == "horizontal";
+    bool m_style = morale_style.value() == "horizontal";
     std::string smiley = morale_emotion( morale_pair.second, get_face_type( u ), m_style );
     mvwprintz( w, point( 8, 0 ), c_light_gray, "%s", u.volume );
 
@@ -1324,7 +1329,7 @@ static void draw_char_wide( avatar &u, const catacurses::window &w )
     nc_color move_color =  move_mode_color( u );
     char move_char = move_mode_string( u );
     std::string movecost = std::to_string( u.movecounter ) + "(" + move_char + ")";
-    bool m_style = get_option<std::string>( "MORALE_STYLE" ) == "horizontal";
+    bool m_style = morale_style.value() == "horizontal";
     std::string smiley = morale_emotion( morale_pair.second, get_face_type( u ), m_style );
 
     mvwprintz( w, point( 8, 0 ), c_light_gray, "%s", u.volume );
@@ -1751,7 +1756,7 @@ static void draw_health_classic( avatar &u, const catacurses::window &w )
 
     // print mood
     std::pair<nc_color, int> morale_pair = morale_stat( u );
-    bool m_style = get_option<std::string>( "MORALE_STYLE" ) == "horizontal";
+    bool m_style = morale_style.value() == "horizontal";
     std::string smiley = morale_emotion( morale_pair.second, get_face_type( u ), m_style );
     mvwprintz( w, point( 34, 1 ), morale_pair.first, smiley );
 
@@ -1769,7 +1774,7 @@ static void draw_health_classic( avatar &u, const catacurses::window &w )
 
     // print safe mode// print safe mode
     std::string safe_str;
-    if( g->safe_mode || get_option<bool>( "AUTOSAFEMODE" ) ) {
+    if( g->safe_mode || autosafemode.value() ) {
         safe_str = "SAFE";
     }
     mvwprintz( w, point( 40, 4 ), safe_color(), safe_str );
@@ -2506,7 +2511,7 @@ std::string panel_manager::get_current_layout_id() const
 
 int panel_manager::get_width_right()
 {
-    if( get_option<std::string>( "SIDEBAR_POSITION" ) == "left" ) {
+    if( sidebar_position.value() == "left" ) {
         return width_left;
     }
     return width_right;
@@ -2514,7 +2519,7 @@ int panel_manager::get_width_right()
 
 int panel_manager::get_width_left()
 {
-    if( get_option<std::string>( "SIDEBAR_POSITION" ) == "left" ) {
+    if( sidebar_position.value() == "left" ) {
         return width_right;
     }
     return width_left;
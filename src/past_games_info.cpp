@@ -3,7 +3,6 @@
 #include <algorithm>
 #include <functional>
 #include <map>
-#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -113,9 +112,9 @@ void past_games_info::ensure_loaded()
 
     for( const std::pair<std::string, std::string> &filename_pair : sortable_filenames ) {
         const std::string &filename = filename_pair.second;
-        std::istringstream iss( read_entire_file( filename ) );
+        const std::string data = read_entire_file( filename );
         try {
-            JsonIn jsin( iss );
+            JsonIn jsin( data, filename );
             info_.emplace_back( jsin );
         } catch( const JsonError &err ) {
             debugmsg( "Error reading memorial file %s: %s", filename, err.what() );
@@ -167,6 +167,10 @@ std::string PATH_INFO::custom_colors()
 {
     return config_dir_value + "custom_colors.json";
 }
+std::string PATH_INFO::data_cache_dir()
+{
+    return user_dir_value + "cache/";
+}
 std::string PATH_INFO::datadir()
 {
     return datadir_value;
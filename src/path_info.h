@@ -19,6 +19,7 @@ std::string colors();
 std::string color_templates();
 std::string config_dir();
 std::string custom_colors();
+std::string data_cache_dir();
 std::string datadir();
 std::string debug();
 std::string defaultsounddir();
@@ -2,16 +2,18 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
-#include <queue>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "cata_utility.h"
 #include "coordinates.h"
 #include "debug.h"
+#include "hierarchical_pathfinding.h"
 #include "line.h"
 #include "map.h"
 #include "mapdata.h"
@@ -24,96 +26,215 @@
 #include "vehicle.h"
 #include "vpart_position.h"
 
-enum astar_state {
+enum astar_state : uint8_t {
     ASL_NONE,
     ASL_OPEN,
     ASL_CLOSED
 };
 
+static constexpr int layer_size = MAPSIZE_X * MAPSIZE_Y;
+
+constexpr uint8_t pathfinding_field::no_step;
+
 // Turns two indexed to a 2D array into an index to equivalent 1D array
 static constexpr int flat_index( const point &p )
 {
     return ( p.x * MAPSIZE_Y ) + p.y;
 }
 
-// Flattened 2D array representing a single z-level worth of pathfinding data
+// Compact index of a tile anywhere in the reality bubble, used instead of tripoints
+// for the open list and the parent links.
+static constexpr int node_index( const tripoint &p )
+{
+    return ( p.z + OVERMAP_DEPTH ) * layer_size + flat_index( p.xy() );
+}
+
+static tripoint node_position( const int node )
+{
+    const int index = node % layer_size;
+    return tripoint( index / MAPSIZE_Y, index % MAPSIZE_Y, node / layer_size - OVERMAP_DEPTH );
+}
+
+// Flattened 2D array representing a single z-level worth of pathfinding data.
+// Entries are only valid if their generation matches the one of the current search,
+// so a layer never needs to be cleared between searches.
 struct path_data_layer {
+    std::array< uint32_t, MAPSIZE_X *MAPSIZE_Y > generation;
     // State is accessed way more often than all other values here
     std::array< astar_state, MAPSIZE_X *MAPSIZE_Y > state;
     std::array< int, MAPSIZE_X *MAPSIZE_Y > score;
     std::array< int, MAPSIZE_X *MAPSIZE_Y > gscore;
-    std::array< tripoint, MAPSIZE_X *MAPSIZE_Y > parent;
+    std::array< int, MAPSIZE_X *MAPSIZE_Y > parent;
 
-    void init( const point &min, const point &max ) {
-        for( int x = min.x; x <= max.x; x++ ) {
-            for( int y = min.y; y <= max.y; y++ ) {
-                const int ind = flat_index( point( x, y ) );
-                state[ind] = ASL_NONE; // Mark as unvisited
-            }
-        }
+    path_data_layer() {
+        generation.fill( 0 );
     }
 };
 
-struct pathfinder {
-    point min;
-    point max;
-    pathfinder( const point &_min, const point &_max ) :
-        min( _min ), max( _max ) {
-    }
+// Open list of A*: scores are small non-negative integers, so a bucket per score
+// replaces a binary heap.  Buckets keep their capacity between searches.
+class bucket_queue
+{
+    public:
+        bool empty() const {
+            return size == 0;
+        }
+
+        void clear() {
+            for( size_t i = min_bucket; i < buckets.size() && size > 0; i++ ) {
+                size -= buckets[i].size();
+                buckets[i].clear();
+            }
+            size = 0;
+            min_bucket = 0;
+        }
 
-    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
-    open;
-    std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
+        void push( const int score, const int node ) {
+            const size_t bucket = std::max( score, 0 );
+            if( bucket >= buckets.size() ) {
+                buckets.resize( std::max( bucket + 1, buckets.size() * 2 ) );
+            }
+            if( bucket < min_bucket ) {
+                min_bucket = bucket;
+            }
+            buckets[bucket].push_back( node );
+            size++;
+        }
 
-    path_data_layer &get_layer( const int z ) {
-        std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
-        if( ptr != nullptr ) {
+        // Score of the entry returned by the last pop()
+        int last_score() const {
+            return static_cast<int>( min_bucket );
+        }
+
+        int pop() {
+            while( buckets[min_bucket].empty() ) {
+                min_bucket++;
+            }
+            const int node = buckets[min_bucket].back();
+            buckets[min_bucket].pop_back();
+            size--;
+            return node;
+        }
+
+    private:
+        std::vector<std::vector<int>> buckets;
+        size_t min_bucket = 0;
+        size_t size = 0;
+};
+
+// Search state of map::route.  One instance is kept per thread and reused for every
+// search, so routing doesn't allocate or clear anything in the steady state.
+class pathfinder
+{
+    public:
+        // Prepares the context for a new search
+        void start() {
+            open.clear();
+            if( ++generation == 0 ) {
+                // Wrapped around, stale stamps could now look current
+                for( std::unique_ptr<path_data_layer> &layer : path_data ) {
+                    if( layer ) {
+                        layer->generation.fill( 0 );
+                    }
+                }
+                generation = 1;
+            }
+        }
+
+        path_data_layer &get_layer( const int z ) {
+            std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
+            if( ptr == nullptr ) {
+                ptr = std::make_unique<path_data_layer>();
+            }
             return *ptr;
         }
 
-        ptr = std::make_unique<path_data_layer>();
-        ptr->init( min, max );
-        return *ptr;
-    }
+        // Returns the state of the tile, resetting it first if it belongs to an earlier search
+        astar_state &state_at( path_data_layer &layer, const int index ) const {
+            if( layer.generation[index] != generation ) {
+                layer.generation[index] = generation;
+                layer.state[index] = ASL_NONE;
+                layer.score[index] = 0;
+                layer.gscore[index] = 0;
+            }
+            return layer.state[index];
+        }
 
-    bool empty() const {
-        return open.empty();
-    }
+        int gscore_at( path_data_layer &layer, const int index ) const {
+            state_at( layer, index );
+            return layer.gscore[index];
+        }
 
-    tripoint get_next() {
-        const auto pt = open.top();
-        open.pop();
-        return pt.second;
-    }
+        int score_at( path_data_layer &layer, const int index ) const {
+            state_at( layer, index );
+            return layer.score[index];
+        }
 
-    void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
-        auto &layer = get_layer( to.z );
-        const int index = flat_index( to.xy() );
-        if( ( layer.state[index] == ASL_OPEN && gscore >= layer.gscore[index] ) ||
-            layer.state[index] == ASL_CLOSED ) {
-            return;
+        bool empty() const {
+            return open.empty();
         }
 
-        layer.state [index] = ASL_OPEN;
-        layer.gscore[index] = gscore;
-        layer.parent[index] = from;
-        layer.score [index] = score;
-        open.push( std::make_pair( score, to ) );
-    }
+        tripoint get_next() {
+            return node_position( open.pop() );
+        }
 
-    void close_point( const tripoint &p ) {
-        auto &layer = get_layer( p.z );
-        const int index = flat_index( p.xy() );
-        layer.state[index] = ASL_CLOSED;
-    }
+        void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
+            auto &layer = get_layer( to.z );
+            const int index = flat_index( to.xy() );
+            astar_state &state = state_at( layer, index );
+            if( ( state == ASL_OPEN && gscore >= layer.gscore[index] ) ||
+                state == ASL_CLOSED ) {
+                return;
+            }
+
+            state = ASL_OPEN;
+            layer.gscore[index] = gscore;
+            layer.parent[index] = node_index( from );
+            layer.score [index] = score;
+            open.push( score, node_index( to ) );
+        }
+
+        void close_point( const tripoint &p ) {
+            auto &layer = get_layer( p.z );
+            state_at( layer, flat_index( p.xy() ) ) = ASL_CLOSED;
+        }
+
+        void unclose_point( const tripoint &p ) {
+            auto &layer = get_layer( p.z );
+            state_at( layer, flat_index( p.xy() ) ) = ASL_NONE;
+        }
+
+    private:
+        bucket_queue open;
+        std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
+        uint32_t generation = 0;
+};
 
-    void unclose_point( const tripoint &p ) {
-        auto &layer = get_layer( p.z );
-        const int index = flat_index( p.xy() );
-        layer.state[index] = ASL_NONE;
+// Tiles with any of these need a closer look, all other tiles are flat ground with a cost of 2
+static constexpr pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
+
+// Neighbors of a tile, opposite directions only differ in the lowest bit
+static constexpr std::array<point, 8> neighbor_offsets{ {
+        point_west, point_east, point_north, point_south,
+        point_north_east, point_south_west, point_north_west, point_south_east
     }
 };
 
+// Minimum number of creatures asking for the same target within a turn before a shared
+// field is built, a few A* searches are cheaper than a search over the whole z-level
+static constexpr int pathfinding_field_min_requests = 4;
+static constexpr size_t max_pathfinding_fields = 8;
+
+// Routes longer than this are planned on the submap level first.  Must be larger than the
+// distance between consecutive waypoints of such a plan, which is at most a submap.
+static constexpr int hierarchical_route_min_dist = 2 * SEEX;
+
+static pathfinder &get_pathfinder()
+{
+    static thread_local pathfinder pf;
+    return pf;
+}
+
 // Modifies `t` to be a tile with `flag` in the overmap tile that `t` was originally on
 // return false if it could not find a suitable point
 template<ter_bitflags flag>
@@ -176,6 +297,93 @@ bool is_disjoint( const Set1 &set1, const Set2 &set2 )
     return true;
 }
 
+int map::route_step_cost( const tripoint &cur, const tripoint &p, const pf_special p_special,
+                          const pathfinding_settings &settings ) const
+{
+    const int bash = settings.bash_strength;
+    const int climb_cost = settings.climb_cost;
+    const bool doors = settings.allow_open_doors;
+
+    int part = -1;
+    const maptile &tile = maptile_at_internal( p );
+    const auto &terrain = tile.get_ter_t();
+    const auto &furniture = tile.get_furn_t();
+    const auto &field = tile.get_field();
+    const vehicle *veh = veh_at_internal( p, part );
+
+    const int cost = move_cost_internal( furniture, terrain, field, veh, part );
+    // Don't calculate bash rating unless we intend to actually use it
+    const int rating = ( bash == 0 || cost != 0 ) ? -1 :
+                       bash_rating_internal( bash, furniture, terrain, false, veh, part );
+
+    if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
+        climb_cost <= 0 ) {
+        return pf_step_closed;
+    }
+
+    if( cost != 0 ) {
+        return cost;
+    }
+
+    if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
+        // Climbing fences
+        return climb_cost;
+    } else if( doors && ( terrain.open || furniture.open ) &&
+               ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
+                 !is_outside( cur ) ) ) {
+        // Only try to open INSIDE doors from the inside
+        // To open and then move onto the tile
+        return 4;
+    } else if( veh != nullptr ) {
+        const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
+        part = vpobst ? vpobst->part_index() : -1;
+        int dummy = -1;
+        if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
+            ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
+              veh_at_internal( cur, dummy ) == veh ) ) {
+            // Handle car doors, but don't try to path through curtains
+            return 10; // One turn to open, 4 to move there
+        } else if( part >= 0 && bash > 0 ) {
+            // Car obstacle that isn't a door
+            // TODO: Account for armor
+            int hp = veh->part( part ).hp();
+            if( hp / 20 > bash ) {
+                // Threshold damage thing means we just can't bash this down
+                return pf_step_closed;
+            } else if( hp / 10 > bash ) {
+                // Threshold damage thing means we will fail to deal damage pretty often
+                hp *= 2;
+            }
+
+            return 2 * hp / bash + 8 + 4;
+        } else if( part >= 0 ) {
+            if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
+                // Won't be openable, don't try from other sides
+                return pf_step_closed;
+            }
+
+            return pf_step_blocked;
+        }
+        // No obstacle part after all, moving there is free
+        return 0;
+    } else if( rating > 1 ) {
+        // Expected number of turns to bash it down, 1 turn to move there
+        // and 5 turns of penalty not to trash everything just because we can
+        return ( 20 / rating ) + 2 + 10;
+    } else if( rating == 1 ) {
+        // Desperate measures, avoid whenever possible
+        return 500;
+    }
+
+    // Unbashable and unopenable from here
+    if( !doors || !terrain.open || !furniture.open ) {
+        // Or anywhere else for that matter
+        return pf_step_closed;
+    }
+
+    return pf_step_blocked;
+}
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const pathfinding_settings &settings,
                                   const std::set<tripoint> &pre_closed ) const
@@ -196,7 +404,6 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     }
     // First, check for a simple straight line on flat ground
     // Except when the line contains a pre-closed tile - we need to do regular pathing then
-    static const pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
     if( f.z == t.z ) {
         const auto line_path = line_to( f, t );
         const auto &pf_cache = get_pathfinding_cache_ref( f.z );
@@ -217,10 +424,24 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         return ret;
     }
 
+    // Long routes would explode the open list (or fail due to the padding below), so plan
+    // them on the submap level first, and fall back to plain A* if that fails
+    if( f.z == t.z && rl_dist( f, t ) > hierarchical_route_min_dist ) {
+        std::vector<tripoint> refined = route_hierarchical( f, t, settings, pre_closed );
+        if( !refined.empty() ) {
+            return refined;
+        }
+    }
+
+    return route_astar( f, t, settings, pre_closed, nullptr );
+}
+
+std::vector<tripoint> map::route_astar( const tripoint &f, const tripoint &t,
+                                        const pathfinding_settings &settings,
+                                        const std::set<tripoint> &pre_closed, int *path_cost ) const
+{
+    std::vector<tripoint> ret;
     int max_length = settings.max_length;
-    int bash = settings.bash_strength;
-    int climb_cost = settings.climb_cost;
-    bool doors = settings.allow_open_doors;
     bool trapavoid = settings.avoid_traps;
     bool roughavoid = settings.avoid_rough_terrain;
     bool sharpavoid = settings.avoid_sharp;
@@ -231,7 +452,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     clip_to_bounds( min.x, min.y, min.z );
     clip_to_bounds( max.x, max.y, max.z );
 
-    pathfinder pf( min.xy(), max.xy() );
+    pathfinder &pf = get_pathfinder();
+    pf.start();
     // Make NPCs not want to path through player
     // But don't make player pathing stop working
     for( const auto &p : pre_closed ) {
@@ -252,7 +474,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
         const int parent_index = flat_index( cur.xy() );
         auto &layer = pf.get_layer( cur.z );
-        auto &cur_state = layer.state[parent_index];
+        auto &cur_state = pf.state_at( layer, parent_index );
         if( cur_state == ASL_CLOSED ) {
             continue;
         }
@@ -286,7 +508,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 continue;
             }
 
-            if( layer.state[index] == ASL_CLOSED ) {
+            astar_state &p_state = pf.state_at( layer, index );
+            if( p_state == ASL_CLOSED ) {
                 continue;
             }
 
@@ -300,89 +523,22 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 newg += 2;
             } else {
                 if( roughavoid ) {
-                    layer.state[index] = ASL_CLOSED; // Close all rough terrain tiles
+                    p_state = ASL_CLOSED; // Close all rough terrain tiles
                     continue;
                 }
 
-                int part = -1;
-                const maptile &tile = maptile_at_internal( p );
-                const auto &terrain = tile.get_ter_t();
-                const auto &furniture = tile.get_furn_t();
-                const auto &field = tile.get_field();
-                const vehicle *veh = veh_at_internal( p, part );
-
-                const int cost = move_cost_internal( furniture, terrain, field, veh, part );
-                // Don't calculate bash rating unless we intend to actually use it
-                const int rating = ( bash == 0 || cost != 0 ) ? -1 :
-                                   bash_rating_internal( bash, furniture, terrain, false, veh, part );
-
-                if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
-                    climb_cost <= 0 ) {
-                    layer.state[index] = ASL_CLOSED; // Close it so that next time we won't try to calculate costs
+                const int cost = route_step_cost( cur, p, p_special, settings );
+                if( cost == pf_step_closed ) {
+                    p_state = ASL_CLOSED; // Close it so that next time we won't try to calculate costs
+                    continue;
+                } else if( cost == pf_step_blocked ) {
                     continue;
                 }
-
                 newg += cost;
-                if( cost == 0 ) {
-                    if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
-                        // Climbing fences
-                        newg += climb_cost;
-                    } else if( doors && ( terrain.open || furniture.open ) &&
-                               ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
-                                 !is_outside( cur ) ) ) {
-                        // Only try to open INSIDE doors from the inside
-                        // To open and then move onto the tile
-                        newg += 4;
-                    } else if( veh != nullptr ) {
-                        const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
-                        part = vpobst ? vpobst->part_index() : -1;
-                        int dummy = -1;
-                        if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
-                            ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
-                              veh_at_internal( cur, dummy ) == veh ) ) {
-                            // Handle car doors, but don't try to path through curtains
-                            newg += 10; // One turn to open, 4 to move there
-                        } else if( part >= 0 && bash > 0 ) {
-                            // Car obstacle that isn't a door
-                            // TODO: Account for armor
-                            int hp = veh->part( part ).hp();
-                            if( hp / 20 > bash ) {
-                                // Threshold damage thing means we just can't bash this down
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            } else if( hp / 10 > bash ) {
-                                // Threshold damage thing means we will fail to deal damage pretty often
-                                hp *= 2;
-                            }
-
-                            newg += 2 * hp / bash + 8 + 4;
-                        } else if( part >= 0 ) {
-                            if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
-                                // Won't be openable, don't try from other sides
-                                layer.state[index] = ASL_CLOSED;
-                            }
-
-                            continue;
-                        }
-                    } else if( rating > 1 ) {
-                        // Expected number of turns to bash it down, 1 turn to move there
-                        // and 5 turns of penalty not to trash everything just because we can
-                        newg += ( 20 / rating ) + 2 + 10;
-                    } else if( rating == 1 ) {
-                        // Desperate measures, avoid whenever possible
-                        newg += 500;
-                    } else {
-                        // Unbashable and unopenable from here
-                        if( !doors || !terrain.open || !furniture.open ) {
-                            // Or anywhere else for that matter
-                            layer.state[index] = ASL_CLOSED;
-                        }
-
-                        continue;
-                    }
-                }
 
                 if( trapavoid && p_special & PF_TRAP ) {
+                    const maptile &tile = maptile_at_internal( p );
+                    const auto &terrain = tile.get_ter_t();
                     const auto &ter_trp = terrain.trap.obj();
                     const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
                     if( !trp.is_benign() ) {
@@ -396,13 +552,13 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                     // Otherwise this would have been a huge fall
                                     auto &layer = pf.get_layer( p.z - 1 );
                                     // From cur, not p, because we won't be walking on air
-                                    pf.add_point( layer.gscore[parent_index] + 10,
-                                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
+                                    pf.add_point( pf.gscore_at( layer, parent_index ) + 10,
+                                                  pf.score_at( layer, parent_index ) + 10 + 2 * rl_dist( below, t ),
                                                   cur, below );
                                 }
 
                                 // Close p, because we won't be walking on it
-                                layer.state[index] = ASL_CLOSED;
+                                p_state = ASL_CLOSED;
                                 continue;
                             }
                         } else if( trapavoid ) {
@@ -413,14 +569,14 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 }
 
                 if( sharpavoid && p_special & PF_SHARP ) {
-                    layer.state[index] = ASL_CLOSED; // Avoid sharp things
+                    p_state = ASL_CLOSED; // Avoid sharp things
                 }
 
             }
 
             // If not visited, add as open
             // If visited, add it only if we can do so with better score
-            if( layer.state[index] == ASL_NONE || newg < layer.gscore[index] ) {
+            if( p_state == ASL_NONE || newg < layer.gscore[index] ) {
                 pf.add_point( newg, newg + 2 * rl_dist( p, t ), cur, p );
             }
         }
@@ -436,8 +592,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z - 1 );
             if( vertical_move_destination<TFLAG_GOES_UP>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( pf.gscore_at( layer, parent_index ) + 2,
+                              pf.score_at( layer, parent_index ) + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -445,8 +601,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z + 1 );
             if( vertical_move_destination<TFLAG_GOES_DOWN>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( pf.gscore_at( layer, parent_index ) + 2,
+                              pf.score_at( layer, parent_index ) + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -455,8 +611,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( above, t ),
+                pf.add_point( pf.gscore_at( layer, parent_index ) + 4,
+                              pf.score_at( layer, parent_index ) + 4 + 2 * rl_dist( above, t ),
                               cur, above );
             }
         }
@@ -465,8 +621,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( above, t ),
+                pf.add_point( pf.gscore_at( layer, parent_index ) + 4,
+                              pf.score_at( layer, parent_index ) + 4 + 2 * rl_dist( above, t ),
                               cur, above );
             }
         }
@@ -475,8 +631,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z - 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint below( cur.x + x_offset[it], cur.y + y_offset[it], cur.z - 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( below, t ),
+                pf.add_point( pf.gscore_at( layer, parent_index ) + 4,
+                              pf.score_at( layer, parent_index ) + 4 + 2 * rl_dist( below, t ),
                               cur, below );
             }
         }
@@ -484,13 +640,16 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     } while( !done && !pf.empty() );
 
     if( done ) {
+        if( path_cost != nullptr ) {
+            *path_cost = pf.get_layer( t.z ).gscore[flat_index( t.xy() )];
+        }
         ret.reserve( rl_dist( f, t ) * 2 );
         tripoint cur = t;
         // Just to limit max distance, in case something weird happens
         for( int fdist = max_length; fdist != 0; fdist-- ) {
             const int cur_index = flat_index( cur.xy() );
             const auto &layer = pf.get_layer( cur.z );
-            const tripoint &par = layer.parent[cur_index];
+            const tripoint par = node_position( layer.parent[cur_index] );
             if( cur == f ) {
                 break;
             }
@@ -512,3 +671,179 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
     return ret;
 }
+
+std::vector<tripoint> map::route_hierarchical( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings, const std::set<tripoint> &pre_closed ) const
+{
+    std::unique_ptr<pathfinding_hierarchy> &hierarchy = pathfinding_hierarchies[f.z + OVERMAP_DEPTH];
+    if( hierarchy == nullptr ) {
+        hierarchy = std::make_unique<pathfinding_hierarchy>();
+    }
+    hierarchy->update( *this, f.z );
+
+    std::vector<tripoint> ret;
+    tripoint from = f;
+    // max_length limits the cost of the whole route, not of each segment
+    pathfinding_settings segment_settings = settings;
+    for( const tripoint &waypoint : hierarchy->plan( *this, f, t ) ) {
+        if( waypoint == from ) {
+            continue;
+        }
+        int segment_cost = 0;
+        const std::vector<tripoint> segment = route_astar( from, waypoint, segment_settings,
+                                              pre_closed, &segment_cost );
+        if( segment.empty() ) {
+            // The rough plan doesn't work out for this pathfinder, or the route is too long
+            return std::vector<tripoint>();
+        }
+        segment_settings.max_length -= segment_cost;
+        ret.insert( ret.end(), segment.begin(), segment.end() );
+        from = waypoint;
+    }
+    return ret;
+}
+
+void map::build_pathfinding_field( pathfinding_field &field ) const
+{
+    const pathfinding_settings &settings = field.settings;
+    const tripoint &t = field.target;
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( t.z );
+    const int mapsize = getmapsize() * SEEX;
+
+    field.cache_generation = pf_cache.generation;
+    field.distance.assign( layer_size, -1 );
+    field.next.assign( layer_size, pathfinding_field::no_step );
+
+    // Reverse Dijkstra from the target: popping a tile settles its distance, after which
+    // all its neighbors are relaxed with the cost of stepping from them onto it.
+    static thread_local bucket_queue open;
+    open.clear();
+    field.distance[flat_index( t.xy() )] = 0;
+    open.push( 0, flat_index( t.xy() ) );
+    while( !open.empty() ) {
+        const int index = open.pop();
+        const int dist = field.distance[index];
+        if( dist < open.last_score() ) {
+            // Stale entry, a shorter distance was found after it was pushed
+            continue;
+        }
+        if( dist > settings.max_length ) {
+            // Everything left is too far away as well
+            break;
+        }
+
+        const tripoint cur( index / MAPSIZE_Y, index % MAPSIZE_Y, t.z );
+        const pf_special cur_special = pf_cache.special[cur.x][cur.y];
+        int enter_penalty = 0;
+        if( cur_special & non_normal ) {
+            if( settings.avoid_rough_terrain ||
+                ( settings.avoid_sharp && cur_special & PF_SHARP ) ) {
+                continue;
+            }
+            if( settings.avoid_traps && cur_special & PF_TRAP ) {
+                const maptile &tile = maptile_at_internal( cur );
+                const ter_t &terrain = tile.get_ter_t();
+                const trap &ter_trp = terrain.trap.obj();
+                const trap &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+                if( !trp.is_benign() ) {
+                    if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
+                        // Ledges lead off this z-level, which the field doesn't cover
+                        continue;
+                    }
+                    enter_penalty = 500;
+                }
+            }
+        }
+
+        for( size_t i = 0; i < neighbor_offsets.size(); i++ ) {
+            const tripoint from = cur + neighbor_offsets[i];
+            if( from.x < 0 || from.x >= mapsize || from.y < 0 || from.y >= mapsize ) {
+                continue;
+            }
+
+            // Penalize for diagonals or the path will look "unnatural"
+            int cost = ( from.x != cur.x && from.y != cur.y ) ? 1 : 0;
+            if( !( cur_special & non_normal ) ) {
+                cost += 2;
+            } else {
+                const int step = route_step_cost( from, cur, cur_special, settings );
+                if( step == pf_step_closed ) {
+                    break;
+                } else if( step == pf_step_blocked ) {
+                    continue;
+                }
+                cost += step + enter_penalty;
+            }
+
+            const int from_index = flat_index( from.xy() );
+            int &from_dist = field.distance[from_index];
+            if( from_dist < 0 || dist + cost < from_dist ) {
+                from_dist = dist + cost;
+                // The step from `from` goes back the way we came
+                field.next[from_index] = static_cast<uint8_t>( i ^ 1 );
+                open.push( from_dist, from_index );
+            }
+        }
+    }
+}
+
+cata::optional<tripoint> map::shared_route_step( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings ) const
+{
+    if( f == t || f.z != t.z || !inbounds( f ) || !inbounds( t ) ||
+        rl_dist( f, t ) > settings.max_dist ) {
+        return cata::nullopt;
+    }
+
+    const int turn = to_turn<int>( calendar::turn );
+    pathfinding_field *field = nullptr;
+    for( const std::unique_ptr<pathfinding_field> &candidate : pathfinding_fields ) {
+        if( candidate->target == t && candidate->settings == settings ) {
+            field = candidate.get();
+            break;
+        }
+    }
+
+    if( field == nullptr ) {
+        if( pathfinding_fields.size() < max_pathfinding_fields ) {
+            pathfinding_fields.emplace_back( std::make_unique<pathfinding_field>() );
+            field = pathfinding_fields.back().get();
+        } else {
+            // Recycle the one that went unused for the longest time
+            field = std::min_element( pathfinding_fields.begin(), pathfinding_fields.end(),
+                                      []( const std::unique_ptr<pathfinding_field> &lhs,
+            const std::unique_ptr<pathfinding_field> &rhs ) {
+                return lhs->last_request_turn < rhs->last_request_turn;
+            } )->get();
+        }
+        field->target = t;
+        field->settings = settings;
+        field->cache_generation = -1;
+        field->requests = 0;
+        field->last_request_turn = turn;
+    }
+
+    if( field->last_request_turn != turn ) {
+        field->last_request_turn = turn;
+        field->requests = 0;
+    }
+    field->requests++;
+
+    if( field->cache_generation >= 0 &&
+        field->cache_generation != get_pathfinding_cache_ref( t.z ).generation ) {
+        // Terrain changed since the field was built
+        field->cache_generation = -1;
+    }
+    if( field->cache_generation < 0 ) {
+        if( field->requests < pathfinding_field_min_requests ) {
+            return cata::nullopt;
+        }
+        build_pathfinding_field( *field );
+    }
+
+    const uint8_t step = field->next[flat_index( f.xy() )];
+    if( step == pathfinding_field::no_step ) {
+        return cata::nullopt;
+    }
+    return f + neighbor_offsets[step];
+}
@@ -2,7 +2,13 @@
 #ifndef CATA_SRC_PATHFINDING_H
 #define CATA_SRC_PATHFINDING_H
 
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
 #include "game_constants.h"
+#include "point.h"
 
 enum pf_special : int {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -38,11 +44,23 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
+// Results of map::route_step_cost for tiles that can't be entered
+// Can't be entered from any side
+constexpr int pf_step_closed = -1;
+// Can't be entered from the current side, but maybe from another one
+constexpr int pf_step_blocked = -2;
+
 struct pathfinding_cache {
     pathfinding_cache();
     ~pathfinding_cache();
 
     bool dirty = false;
+    // Incremented every time the cache is rebuilt, lets derived data detect it went stale
+    int generation = 0;
+    // Submaps (x * MAPSIZE + y) whose tiles may have changed since the last rebuild
+    std::bitset<MAPSIZE * MAPSIZE> dirty_submaps;
+    // Generation of the last rebuild that followed a change to each submap
+    std::array<int, MAPSIZE * MAPSIZE> submap_generation;
 
     pf_special special[MAPSIZE_X][MAPSIZE_Y];
 };
@@ -72,6 +90,40 @@ struct pathfinding_settings {
           avoid_sharp( as ) {}
 
     pathfinding_settings &operator=( const pathfinding_settings & ) = default;
+
+    bool operator==( const pathfinding_settings &rhs ) const {
+        return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+               max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+               allow_open_doors == rhs.allow_open_doors && avoid_traps == rhs.avoid_traps &&
+               allow_climb_stairs == rhs.allow_climb_stairs &&
+               avoid_rough_terrain == rhs.avoid_rough_terrain && avoid_sharp == rhs.avoid_sharp;
+    }
+    bool operator!=( const pathfinding_settings &rhs ) const {
+        return !( *this == rhs );
+    }
+};
+
+/**
+ * Distance from every tile of a z-level to a single target, for the given settings.
+ * Built by a reverse Dijkstra search from the target, so any number of creatures heading
+ * to the same target can read their next step in constant time, see @ref map::shared_route_step.
+ * The field only covers the z-level of the target and ignores creatures, just like
+ * @ref map::route ignores them.
+ */
+struct pathfinding_field {
+    static constexpr uint8_t no_step = 0xFF;
+
+    tripoint target;
+    pathfinding_settings settings;
+    // pathfinding_cache::generation the field was built from, -1 if not built
+    int cache_generation = -1;
+    // Number of requests for this field during @ref last_request_turn
+    int requests = 0;
+    int last_request_turn = 0;
+    // Cost to reach the target from each tile, -1 if unreachable
+    std::vector<int> distance;
+    // Index into the neighbor offsets of the next step towards the target, or no_step
+    std::vector<uint8_t> next;
 };
 
 #endif // CATA_SRC_PATHFINDING_H
@@ -0,0 +1,305 @@
+#include "region_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+#include "cata_utility.h"
+#include "coordinate_conversions.h"
+#include "filesystem.h"
+#include "game_constants.h"
+#include "string_formatter.h"
+
+static const std::string region_magic( "\x89" "CDDARGN", 8 );
+static constexpr int region_quads = SEG_SIZE * SEG_SIZE;
+static constexpr size_t table_entry_size = 8;
+// Checksum and generation, followed by the table
+static constexpr size_t table_slot_size = 8 + region_quads * table_entry_size;
+static constexpr size_t sector_size = 4096;
+// Magic and both tables, rounded up to whole sectors
+static constexpr uint32_t header_sectors =
+    ( 8 + 2 * table_slot_size + sector_size - 1 ) / sector_size;
+
+static uint32_t read_uint32( const char *bytes )
+{
+    uint32_t result = 0;
+    for( int i = 3; i >= 0; --i ) {
+        result = result << 8 | static_cast<uint8_t>( bytes[i] );
+    }
+    return result;
+}
+
+static void write_uint32( char *bytes, uint32_t value )
+{
+    for( int i = 0; i < 4; ++i ) {
+        bytes[i] = static_cast<char>( value & 0xFF );
+        value >>= 8;
+    }
+}
+
+// FNV-1a, only meant to detect a table that was not written completely
+static uint32_t table_checksum( const char *data, const size_t size )
+{
+    uint32_t hash = 2166136261u;
+    for( size_t i = 0; i < size; ++i ) {
+        hash = ( hash ^ static_cast<uint8_t>( data[i] ) ) * 16777619u;
+    }
+    return hash;
+}
+
+static int quad_index( const point &quad )
+{
+    if( quad.x < 0 || quad.x >= SEG_SIZE || quad.y < 0 || quad.y >= SEG_SIZE ) {
+        throw std::runtime_error( "quad position outside of the region" );
+    }
+    return quad.y * SEG_SIZE + quad.x;
+}
+
+region_file::region_file( const std::string &path ) : path( path )
+{
+}
+
+region_file::region_file( region_file && ) noexcept = default;
+
+region_file::~region_file() = default;
+
+region_file::header region_file::read_header( std::istream &fin ) const
+{
+    std::string data( region_magic.size() + 2 * table_slot_size, '\0' );
+    fin.read( &data[0], data.size() );
+    if( !fin || data.compare( 0, region_magic.size(), region_magic ) != 0 ) {
+        throw std::runtime_error( "\"" + path + "\" is not a map region file" );
+    }
+    header result;
+    for( int slot = 0; slot < 2; ++slot ) {
+        const char *pos = data.data() + region_magic.size() + slot * table_slot_size;
+        const uint32_t generation = read_uint32( pos + 4 );
+        if( generation > result.generation &&
+            read_uint32( pos ) == table_checksum( pos + 4, table_slot_size - 4 ) ) {
+            result.slot = slot;
+            result.generation = generation;
+        }
+    }
+    if( result.generation == 0 ) {
+        throw std::runtime_error( "the tables of \"" + path + "\" are damaged" );
+    }
+    result.table.resize( region_quads );
+    const char *pos = data.data() + region_magic.size() + result.slot * table_slot_size + 8;
+    for( table_entry &entry : result.table ) {
+        entry.sector = read_uint32( pos );
+        entry.size = read_uint32( pos + 4 );
+        pos += table_entry_size;
+    }
+    return result;
+}
+
+std::string region_file::table_slot( const uint32_t generation,
+                                     const std::vector<table_entry> &table )
+{
+    std::string data( table_slot_size, '\0' );
+    write_uint32( &data[4], generation );
+    for( int i = 0; i < region_quads; ++i ) {
+        write_uint32( &data[8 + i * table_entry_size], table[i].sector );
+        write_uint32( &data[8 + i * table_entry_size + 4], table[i].size );
+    }
+    write_uint32( &data[0], table_checksum( &data[4], table_slot_size - 4 ) );
+    return data;
+}
+
+bool region_file::open_reader() const
+{
+    if( reader ) {
+        return true;
+    }
+    std::unique_ptr<std::ifstream> fin = std::make_unique<std::ifstream>( path, std::ios::binary );
+    if( !*fin ) {
+        // No quad of this region has been saved yet
+        return false;
+    }
+    if( table.empty() ) {
+        table = read_header( *fin ).table;
+    }
+    reader = std::move( fin );
+    return true;
+}
+
+bool region_file::read( const point &quad, std::string &data ) const
+{
+    const int index = quad_index( quad );
+    if( !open_reader() ) {
+        return false;
+    }
+    const table_entry entry = table[index];
+    if( entry.sector == 0 ) {
+        return false;
+    }
+    data.resize( entry.size );
+    reader->clear();
+    reader->seekg( static_cast<std::streamoff>( entry.sector ) * sector_size );
+    reader->read( &data[0], entry.size );
+    if( !*reader ) {
+        reader.reset();
+        throw std::runtime_error( "quad data in \"" + path + "\" is truncated" );
+    }
+    return true;
+}
+
+std::vector<point> region_file::quads() const
+{
+    std::vector<point> result;
+    if( !open_reader() ) {
+        return result;
+    }
+    for( int i = 0; i < region_quads; ++i ) {
+        if( table[i].sector != 0 ) {
+            result.emplace_back( i % SEG_SIZE, i / SEG_SIZE );
+        }
+    }
+    return result;
+}
+
+void region_file::write( const std::vector<std::pair<point, std::string>> &quads )
+{
+    if( !file_exist( path ) ) {
+        // Through a temporary file, so there never is a half created region file
+        write_to_file( path, []( std::ostream & fout ) {
+            fout << region_magic << table_slot( 1, std::vector<table_entry>( region_quads ) )
+                 << std::string( table_slot_size, '\0' );
+        } );
+    }
+    // The reader might have buffered what is overwritten now
+    reader.reset();
+    std::fstream file( path, std::ios::binary | std::ios::in | std::ios::out );
+    if( !file ) {
+        throw std::runtime_error( "opening \"" + path + "\" failed" );
+    }
+    // Read again instead of using the table, as only the file is sure to be current
+    const header current = read_header( file );
+
+    // Sectors in use by the header or by the quads currently in the table
+    std::vector<bool> used( header_sectors, true );
+    const auto mark = [&used]( const uint32_t first, const uint32_t count, const bool value ) {
+        if( used.size() < first + count ) {
+            used.resize( first + count, false );
+        }
+        std::fill( used.begin() + first, used.begin() + first + count, value );
+    };
+    const auto sectors_for = []( const size_t size ) {
+        const size_t sectors = ( size + sector_size - 1 ) / sector_size;
+        return static_cast<uint32_t>( std::max<size_t>( 1, sectors ) );
+    };
+    for( const table_entry &entry : current.table ) {
+        if( entry.sector != 0 ) {
+            mark( entry.sector, sectors_for( entry.size ), true );
+        }
+    }
+
+    // Write all data first, the current table stays valid until the other one is replaced
+    std::vector<table_entry> new_table = current.table;
+    for( const std::pair<point, std::string> &quad : quads ) {
+        const uint32_t needed = sectors_for( quad.second.size() );
+        uint32_t first = header_sectors;
+        uint32_t free_run = 0;
+        for( uint32_t sector = header_sectors; sector < used.size() && free_run < needed;
+             ++sector ) {
+            if( used[sector] ) {
+                first = sector + 1;
+                free_run = 0;
+            } else {
+                ++free_run;
+            }
+        }
+        // If no run is big enough, this continues the last free run or appends to the file
+        mark( first, needed, true );
+        file.seekp( static_cast<std::streamoff>( first ) * sector_size );
+        file.write( quad.second.data(), quad.second.size() );
+        table_entry &entry = new_table[quad_index( quad.first )];
+        entry.sector = first;
+        entry.size = static_cast<uint32_t>( quad.second.size() );
+    }
+    file.flush();
+    // The new table must not reach the disk before the data it points to
+    if( !file || !sync_file( path ) ) {
+        throw std::runtime_error( "writing to \"" + path + "\" failed" );
+    }
+
+    const std::string slot_data = table_slot( current.generation + 1, new_table );
+    file.seekp( region_magic.size() + ( 1 - current.slot ) * table_slot_size );
+    file.write( slot_data.data(), slot_data.size() );
+    file.flush();
+    if( !file || !sync_file( path ) ) {
+        throw std::runtime_error( "writing to \"" + path + "\" failed" );
+    }
+    table = std::move( new_table );
+}
+
+std::string region_file_path( const std::string &maps_dir, const tripoint &om_addr )
+{
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    return string_format( "%s/%d.%d.%d.region", maps_dir, segment_addr.x, segment_addr.y,
+                          segment_addr.z );
+}
+
+point region_quad_position( const tripoint &om_addr )
+{
+    const tripoint segment_addr = omt_to_seg_copy( om_addr );
+    return om_addr.xy() - segment_addr.xy() * SEG_SIZE;
+}
+
+int migrate_quad_files_to_regions( const std::string &maps_dir )
+{
+    struct quad_file {
+        point quad;
+        std::string path;
+    };
+    std::map<std::string, std::vector<quad_file>> by_region;
+    std::set<std::string> segment_dirs;
+    for( const std::string &path : get_files_from_path( ".map", maps_dir, true, true ) ) {
+        const size_t name_start = path.find_last_of( "/\\" ) + 1;
+        std::string name = path.substr( name_start );
+        // Very old saves could contain thousands separators, but not if they are dots
+        name.erase( std::remove( name.begin(), name.end(), ',' ), name.end() );
+        tripoint om_addr;
+        if( std::count( name.begin(), name.end(), '.' ) != 3 ||
+            sscanf( name.c_str(), "%d.%d.%d.map", &om_addr.x, &om_addr.y, &om_addr.z ) != 3 ) {
+            continue;
+        }
+        by_region[region_file_path( maps_dir, om_addr )].push_back(
+            quad_file{ region_quad_position( om_addr ), path } );
+        segment_dirs.insert( path.substr( 0, name_start - 1 ) );
+    }
+
+    int migrated = 0;
+    for( const std::pair<const std::string, std::vector<quad_file>> &region : by_region ) {
+        region_file file( region.first );
+        std::vector<std::pair<point, std::string>> quads;
+        for( const quad_file &quad : region.second ) {
+            std::string contents = read_entire_file( quad.path );
+            if( contents.empty() ) {
+                throw std::runtime_error( "reading \"" + quad.path + "\" failed" );
+            }
+            quads.emplace_back( quad.quad, std::move( contents ) );
+        }
+        file.write( quads );
+        migrated += static_cast<int>( quads.size() );
+
+        // Only remove the old files of the quads that can be read back from the region
+        std::map<point, std::string> moved( quads.begin(), quads.end() );
+        for( const quad_file &quad : region.second ) {
+            std::string stored;
+            if( !file.read( quad.quad, stored ) || stored != moved[quad.quad] ) {
+                throw std::runtime_error( "\"" + quad.path + "\" was not stored correctly in \"" +
+                                          region.first + "\"" );
+            }
+            remove_file( quad.path );
+        }
+    }
+    for( const std::string &dir : segment_dirs ) {
+        // Fails if anything else is left in there, which is fine
+        remove_directory( dir );
+    }
+    return migrated;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef CATA_SRC_REGION_FILE_H
+#define CATA_SRC_REGION_FILE_H
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "point.h"
+
+/**
+ * A file holding the saved map quads of one segment (SEG_SIZE x SEG_SIZE overmap terrain
+ * tiles of one z-level), instead of one file per quad.
+ *
+ * The file starts with magic bytes and two copies of a table with the location (first
+ * sector) and size of every quad, followed by the quads themselves, each in a run of
+ * sectors. Every table has a generation number and a checksum, and the valid table with
+ * the higher generation is the current one. A write puts the new quads into sectors the
+ * current table does not use, and then replaces the other table. If that is interrupted,
+ * the torn table fails its checksum and the previous version of the file is still read.
+ * Sectors of replaced quads are reused by later writes.
+ *
+ * Quads are addressed by their position within the segment, 0 to SEG_SIZE - 1 on each axis.
+ * The contents of a quad are opaque to this class. All functions throw std::runtime_error
+ * on I/O errors or if the file is malformed.
+ *
+ * The file stays open for reading and its table is only parsed once. Writes through the same
+ * object keep it up to date, but changes made to the file otherwise need a new object.
+ */
+class region_file
+{
+    public:
+        explicit region_file( const std::string &path );
+        region_file( region_file && ) noexcept;
+        ~region_file();
+
+        /** Reads the contents of the quad into @p data, returns false if it is not in the file. */
+        bool read( const point &quad, std::string &data ) const;
+        /** Adds or replaces the given quads. Creates the file if necessary. */
+        void write( const std::vector<std::pair<point, std::string>> &quads );
+        /** Positions of all quads in the file. */
+        std::vector<point> quads() const;
+
+    private:
+        struct table_entry {
+            uint32_t sector = 0;
+            uint32_t size = 0;
+        };
+        struct header {
+            /** Which of the two tables is the current one. */
+            int slot = 0;
+            uint32_t generation = 0;
+            std::vector<table_entry> table;
+        };
+        header read_header( std::istream &fin ) const;
+        /** Opens @ref reader and reads @ref table if needed, returns false if there is no file. */
+        bool open_reader() const;
+        /** Checksum, generation and table, as stored in one of the two table slots. */
+        static std::string table_slot( uint32_t generation, const std::vector<table_entry> &table );
+
+        std::string path;
+        // Kept open between reads, closed by writes
+        mutable std::unique_ptr<std::ifstream> reader;
+        // Current table of the file, empty until it is read or written
+        mutable std::vector<table_entry> table;
+};
+
+/** Path of the region file in @p maps_dir that holds the quad at the overmap terrain @p om_addr. */
+std::string region_file_path( const std::string &maps_dir, const tripoint &om_addr );
+/** Position of the quad at the overmap terrain @p om_addr within its region file. */
+point region_quad_position( const tripoint &om_addr );
+
+/**
+ * Moves the quads that were saved as one file per quad below @p maps_dir into region files,
+ * and removes the old files. Files of single quads are only left by saves without region files,
+ * so they replace the quads that are already in a region file. Every quad is read back from its
+ * region file before its old file is removed, old files of quads that do not match are kept and
+ * std::runtime_error is thrown.
+ * Returns the number of quads moved.
+ */
+int migrate_quad_files_to_regions( const std::string &maps_dir );
+
+#endif // CATA_SRC_REGION_FILE_H
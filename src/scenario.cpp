@@ -158,12 +158,16 @@ void scenario::reset()
     all_scenarios.reset();
 }
 
+void scenario::finalize()
+{
+    sc_blacklist.finalize();
+}
+
 void scenario::check_definitions()
 {
     for( const auto &scen : all_scenarios.get_all() ) {
         scen.check_definition();
     }
-    sc_blacklist.finalize();
 }
 
 static void check_traits( const std::set<trait_id> &traits, const string_id<scenario> &ident )
@@ -74,6 +74,8 @@ class scenario
 
         // clear scenario map, every scenario pointer becomes invalid!
         static void reset();
+        /** Resolves the scenario blacklist, once all scenarios are loaded */
+        static void finalize();
         /** calls @ref check_definition for each scenario */
         static void check_definitions();
         /** Check that item definitions are valid */
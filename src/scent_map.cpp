@@ -1,6 +1,7 @@
 #include "scent_map.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdlib>
 #include <new>
 
@@ -192,17 +193,57 @@ void scent_map::update( const tripoint &center, map &m )
     // stability. This is essentially a decimal number * 1000.
     const int diffusivity = 100;
 
+    // Scent only spreads from scented squares to their neighbors, everything else stays at
+    // zero and needs neither the flag lookups nor the diffusion below. So only look at the
+    // columns next to scented ones, in the rows next to the scented ones.
+    std::array<bool, MAPSIZE_X> diffuses_in_column = {};
+    int scented_miny = scentmap_maxy + 2;
+    int scented_maxy = scentmap_miny - 2;
+    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        bool has_scent = false;
+        for( int y = scentmap_miny - 1; y <= scentmap_maxy + 1; ++y ) {
+            if( grscent[x][y] != 0 ) {
+                has_scent = true;
+                scented_miny = std::min( scented_miny, y );
+                scented_maxy = std::max( scented_maxy, y );
+            }
+        }
+        if( has_scent ) {
+            const int last = std::min( x + 1, scentmap_maxx );
+            for( int i = std::max( x - 1, scentmap_minx ); i <= last; ++i ) {
+                diffuses_in_column[i] = true;
+            }
+        }
+    }
+    if( scented_miny > scented_maxy ) {
+        return;
+    }
+    int minx = scentmap_minx;
+    while( !diffuses_in_column[minx] ) {
+        ++minx;
+    }
+    int maxx = scentmap_maxx;
+    while( !diffuses_in_column[maxx] ) {
+        --maxx;
+    }
+    const int miny = std::max( scented_miny - 1, scentmap_miny );
+    const int maxy = std::min( scented_maxy + 1, scentmap_maxy );
+
     // The new scent flag searching function. Should be wayyy faster than the old one.
-    m.scent_blockers( blocks_scent, reduces_scent, point( scentmap_minx - 1, scentmap_miny - 1 ),
-                      point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+    m.scent_blockers( blocks_scent, reduces_scent, point( minx - 1, miny - 1 ),
+                      point( maxx + 1, maxy + 1 ) );
     // Sum neighbors in the y direction.  This way, each square gets called 3 times instead of 9
     // times. This cost us an extra loop here, but it also eliminated a loop at the end, so there
     // is a net performance improvement over the old code. Could probably still be better.
     // note: this method needs an array that is one square larger on each side in the x direction
     // than the final scent matrix. I think this is fine since SCENT_RADIUS is less than
     // MAPSIZE_X, but if that changes, this may need tweaking.
-    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+    for( int x = minx - 1; x <= maxx + 1; ++x ) {
+        if( !( x > minx && diffuses_in_column[x - 1] ) && !diffuses_in_column[x] &&
+            !( x < maxx && diffuses_in_column[x + 1] ) ) {
+            continue;
+        }
+        for( int y = miny; y <= maxy; ++y ) {
             // remember the sum of the scent val for the 3 neighboring squares that can defuse into
             sum_3_scent_y[y][x] = 0;
             squares_used_y[y][x] = 0;
@@ -222,8 +263,11 @@ void scent_map::update( const tripoint &center, map &m )
     }
 
     // Rest of the scent map
-    for( int x = scentmap_minx; x <= scentmap_maxx; ++x ) {
-        for( int y = scentmap_miny; y <= scentmap_maxy; ++y ) {
+    for( int x = minx; x <= maxx; ++x ) {
+        if( !diffuses_in_column[x] ) {
+            continue;
+        }
+        for( int y = miny; y <= maxy; ++y ) {
             int &scent_here = grscent[x][y];
             if( !blocks_scent[x][y] ) {
                 // to how many neighboring squares do we diffuse out? (include our own square
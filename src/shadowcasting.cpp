@@ -1,5 +1,6 @@
 #include "shadowcasting.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <iterator>
@@ -10,6 +11,93 @@
 #include "list.h"
 #include "point.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#   define CATA_SHADOWCASTING_SSE2
+#   include <emmintrin.h>
+#endif
+#if defined(__AVX__)
+#   include <immintrin.h>
+#endif
+
+int transparency_run_length_scalar( const float *first, const int stride, const int count,
+                                    const float value )
+{
+    int i = 0;
+    while( i < count && first[i * stride] == value ) {
+        ++i;
+    }
+    return i;
+}
+
+void raise_to_at_least_scalar( float *first, const int stride, const int count, const float value )
+{
+    for( int i = 0; i < count; ++i ) {
+        float &v = first[i * stride];
+        v = std::max( v, value );
+    }
+}
+
+#if defined(CATA_SHADOWCASTING_SSE2)
+// Number of leading set bits of a comparison mask, in row order.  Backwards rows are loaded
+// from their lowest address, so their first element is in the highest lane.
+static int leading_matches( const int mask, const int lanes, const bool backwards )
+{
+    int n = 0;
+    while( n < lanes && ( mask & ( 1 << ( backwards ? lanes - 1 - n : n ) ) ) ) {
+        ++n;
+    }
+    return n;
+}
+#endif
+
+int transparency_run_length( const float *first, const int stride, const int count,
+                             const float value )
+{
+    int i = 0;
+#if defined(CATA_SHADOWCASTING_SSE2)
+    if( stride == 1 || stride == -1 ) {
+        const bool backwards = stride < 0;
+#if defined(__AVX__)
+        const __m256 value8 = _mm256_set1_ps( value );
+        for( ; i + 8 <= count; i += 8 ) {
+            const float *block = backwards ? first - i - 7 : first + i;
+            const int mask = _mm256_movemask_ps( _mm256_cmp_ps( _mm256_loadu_ps( block ), value8,
+                                                 _CMP_EQ_OQ ) );
+            if( mask != 0xFF ) {
+                return i + leading_matches( mask, 8, backwards );
+            }
+        }
+#endif
+        const __m128 value4 = _mm_set1_ps( value );
+        for( ; i + 4 <= count; i += 4 ) {
+            const float *block = backwards ? first - i - 3 : first + i;
+            const int mask = _mm_movemask_ps( _mm_cmpeq_ps( _mm_loadu_ps( block ), value4 ) );
+            if( mask != 0xF ) {
+                return i + leading_matches( mask, 4, backwards );
+            }
+        }
+    }
+#endif
+    return i + transparency_run_length_scalar( first + i * stride, stride, count - i, value );
+}
+
+void raise_to_at_least( float *first, const int stride, const int count, const float value )
+{
+    int i = 0;
+#if defined(CATA_SHADOWCASTING_SSE2)
+    if( stride == 1 || stride == -1 ) {
+        const bool backwards = stride < 0;
+        // max( value, v ) picks v unless value is greater, same as std::max( v, value )
+        const __m128 value4 = _mm_set1_ps( value );
+        for( ; i + 4 <= count; i += 4 ) {
+            float *block = backwards ? first - i - 3 : first + i;
+            _mm_storeu_ps( block, _mm_max_ps( value4, _mm_loadu_ps( block ) ) );
+        }
+    }
+#endif
+    raise_to_at_least_scalar( first + i * stride, stride, count - i, value );
+}
+
 struct slope {
     slope( int_least8_t rise, int_least8_t run ) {
         // Ensure run is always positive for the inequality operators
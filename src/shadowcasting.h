@@ -113,6 +113,18 @@ inline float accumulate_transparency( const float &cumulative_transparency,
     return ( ( distance - 1 ) * cumulative_transparency + current_transparency ) / distance;
 }
 
+// Row kernels for the shadowcasting loops.  A row starts at first and has count elements,
+// each stride elements after the previous one.  Rows with a stride of 1 or -1 are contiguous
+// in memory and get vectorized where the target supports it.
+
+// Number of elements at the start of the row that are equal to value.
+int transparency_run_length( const float *first, int stride, int count, float value );
+// Raises every element of the row to at least value.
+void raise_to_at_least( float *first, int stride, int count, float value );
+// Scalar versions of the above, used as fallback and to test the vectorized ones against.
+int transparency_run_length_scalar( const float *first, int stride, int count, float value );
+void raise_to_at_least_scalar( float *first, int stride, int count, float value );
+
 template<typename T, typename Out, T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
          void( *update_output )( Out &, const T &, quadrant ),
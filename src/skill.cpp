@@ -213,7 +213,8 @@ void SkillLevel::train( int amount, bool skip_scaling )
     if( skip_scaling ) {
         _exercise += amount;
     } else {
-        const double scaling = get_option<float>( "SKILL_TRAINING_SPEED" );
+        static const option_handle<float> skill_training_speed( "SKILL_TRAINING_SPEED" );
+        const double scaling = skill_training_speed.value();
         if( scaling > 0.0 ) {
             _exercise += roll_remainder( amount * scaling );
         }
@@ -250,7 +251,8 @@ time_duration rustRate( int level )
 
 bool SkillLevel::isRusting() const
 {
-    return get_option<std::string>( "SKILL_RUST" ) != "off" && ( _level > 0 ) &&
+    static const option_handle<std::string> skill_rust( "SKILL_RUST" );
+    return skill_rust.value() != "off" && ( _level > 0 ) &&
            calendar::turn - _lastPracticed > rustRate( _level );
 }
 
@@ -269,7 +271,8 @@ bool SkillLevel::rust( int rust_resist, int character_rate )
     }
 
     _exercise -= _level * 100;
-    const std::string &rust_type = get_option<std::string>( "SKILL_RUST" );
+    static const option_handle<std::string> skill_rust( "SKILL_RUST" );
+    const std::string &rust_type = skill_rust.value();
     if( _exercise < 0 ) {
         if( rust_type == "vanilla" || rust_type == "int" ) {
             _exercise = ( 100 * 100 * _level * _level ) - 1;
@@ -298,7 +301,8 @@ void SkillLevel::readBook( int minimumGain, int maximumGain, int maximumLevel )
 
 bool SkillLevel::can_train() const
 {
-    return get_option<float>( "SKILL_TRAINING_SPEED" ) > 0.0;
+    static const option_handle<float> skill_training_speed( "SKILL_TRAINING_SPEED" );
+    return skill_training_speed.value() > 0.0;
 }
 
 const SkillLevel &SkillLevelMap::get_skill_level_object( const skill_id &ident ) const
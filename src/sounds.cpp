@@ -14,6 +14,7 @@
 #include "character.h"
 #include "coordinate_conversions.h"
 #include "coordinates.h"
+#include "creature_tracker.h"
 #include "debug.h"
 #include "effect.h"
 #include "enums.h"
@@ -357,12 +358,20 @@ void sounds::process_sounds()
             overmap_buffer.signal_hordes( target, sig_power );
         }
         // Alert all monsters (that can hear) to the sound.
-        for( monster &critter : g->all_monsters() ) {
+        if( vol <= 0 ) {
+            continue;
+        }
+        // sound_distance is at least the horizontal distance and five times the vertical
+        // one, so only monsters in this box can be in range
+        const int max_dist = vol * 2 - 1;
+        const tripoint reach( max_dist, max_dist, max_dist / 5 );
+        for( monster *critter : g->critter_tracker->find_in_rectangle( source - reach,
+                source + reach ) ) {
             // TODO: Generalize this to Creature::hear_sound
-            const int dist = sound_distance( source, critter.pos() );
+            const int dist = sound_distance( source, critter->pos() );
             if( vol * 2 > dist ) {
                 // Exclude monsters that certainly won't hear the sound
-                critter.hear_sound( source, vol, dist, this_centroid.provocative );
+                critter->hear_sound( source, vol, dist, this_centroid.provocative );
             }
         }
     }
@@ -206,6 +206,41 @@ void submap::delete_computer( const point &p )
     computers.erase( p );
 }
 
+bool submap::add_field( const point &p, const field_type_id &type, int intensity,
+                        const time_duration &age )
+{
+    if( !get_field( p ).add_field( type, intensity, age ) ) {
+        return false;
+    }
+    field_count++;
+    list_field_tile( p );
+    return true;
+}
+
+void submap::list_field_tile( const point &p )
+{
+    const size_t index = p.x * SEEY + p.y;
+    if( !listed_field_tiles[index] ) {
+        listed_field_tiles[index] = true;
+        field_tiles.push_back( p );
+    }
+}
+
+void submap::update_field_tiles()
+{
+    const auto without_fields = [this]( const point & p ) {
+        if( get_field( p ).field_count() > 0 ) {
+            return false;
+        }
+        listed_field_tiles[p.x * SEEY + p.y] = false;
+        return true;
+    };
+    field_tiles.erase( std::remove_if( field_tiles.begin(), field_tiles.end(), without_fields ),
+                       field_tiles.end() );
+    // Same order as a scan over all tiles
+    std::sort( field_tiles.begin(), field_tiles.end() );
+}
+
 bool submap::contains_vehicle( vehicle *veh )
 {
     const auto match = std::find_if(
@@ -263,6 +298,12 @@ void submap::rotate( int turns )
 
     active_items.rotate_locations( turns, { SEEX, SEEY } );
 
+    listed_field_tiles.reset();
+    for( point &p : field_tiles ) {
+        p = rotate_point( p );
+        listed_field_tiles[p.x * SEEY + p.y] = true;
+    }
+
     for( auto &elem : cosmetics ) {
         elem.pos = rotate_point( elem.pos );
     }
@@ -2,6 +2,7 @@
 #ifndef CATA_SRC_SUBMAP_H
 #define CATA_SRC_SUBMAP_H
 
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
 #include <iosfwd>
@@ -27,9 +28,13 @@
 class JsonIn;
 class JsonOut;
 class basecamp;
+class binary_reader;
+class binary_writer;
 class map;
 class vehicle;
 struct furn_t;
+struct resolved_submap_palettes;
+struct submap_palettes;
 struct ter_t;
 struct trap;
 
@@ -176,6 +181,25 @@ class submap : maptile_soa<SEEX, SEEY>
             return fld[p.x][p.y];
         }
 
+        /**
+         * Adds a field to the tile like @ref field::add_field, counts it in @ref field_count
+         * and lists the tile in @ref get_field_tiles.
+         * @return true if the field was not on the tile before.
+         */
+        bool add_field( const point &p, const field_type_id &type, int intensity,
+                        const time_duration &age );
+
+        /**
+         * Tiles with fields, so processing the fields does not have to look at every tile.
+         * A tile is listed once it gets a field and stays listed until
+         * @ref update_field_tiles finds it without fields.
+         */
+        const std::vector<point> &get_field_tiles() const {
+            return field_tiles;
+        }
+        /** Drops the tiles without fields from @ref get_field_tiles and sorts the rest. */
+        void update_field_tiles();
+
         struct cosmetic_t {
             point pos;
             std::string type;
@@ -227,7 +251,12 @@ class submap : maptile_soa<SEEX, SEEY>
         void rotate( int turns );
 
         void store( JsonOut &jsout ) const;
+        /** Writes the members of @ref store except terrain, furniture, traps and radiation. */
+        void store_contents( JsonOut &jsout ) const;
         void load( JsonIn &jsin, const std::string &member_name, int version );
+        /** Binary counterparts of @ref store and @ref load, see submap_binary.h. */
+        void store_binary( binary_writer &out, submap_palettes &palettes ) const;
+        void load_binary( binary_reader &in, const resolved_submap_palettes &palettes, int version );
 
         // If is_uniform is true, this submap is a solid block of terrain
         // Uniform submaps aren't saved/loaded, because regenerating them is faster
@@ -253,8 +282,15 @@ class submap : maptile_soa<SEEX, SEEY>
         std::map<point, computer> computers;
         std::unique_ptr<computer> legacy_computer;
         int temperature = 0;
+        std::vector<point> field_tiles;
+        // Tiles in field_tiles, indexed by x * SEEY + y
+        std::bitset<SEEX * SEEY> listed_field_tiles;
 
+        void list_field_tile( const point &p );
         void update_legacy_computer();
+        /** Parts of @ref store shared with @ref store_contents. */
+        void store_items( JsonOut &jsout ) const;
+        void store_entities( JsonOut &jsout ) const;
 
         static constexpr size_t elements = SEEX * SEEY;
 };
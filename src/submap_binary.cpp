@@ -0,0 +1,309 @@
+#include "submap_binary.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "calendar.h"
+#include "game.h"
+#include "game_constants.h"
+#include "json.h"
+#include "mapdata.h"
+#include "point.h"
+#include "string_id.h"
+#include "submap.h"
+#include "trap.h"
+
+// Version of the layout described in submap_binary.h, not of the game data in it
+static constexpr uint64_t submap_binary_format_version = 1;
+
+const std::string submap_binary_magic( "\x89" "CDDAMAP", 8 );
+
+void binary_writer::write_varint( uint64_t value )
+{
+    while( value >= 0x80 ) {
+        buffer.push_back( static_cast<char>( ( value & 0x7F ) | 0x80 ) );
+        value >>= 7;
+    }
+    buffer.push_back( static_cast<char>( value ) );
+}
+
+void binary_writer::write_signed( const int64_t value )
+{
+    write_varint( ( static_cast<uint64_t>( value ) << 1 ) ^ static_cast<uint64_t>( value >> 63 ) );
+}
+
+void binary_writer::write_uint16( const uint16_t value )
+{
+    buffer.push_back( static_cast<char>( value & 0xFF ) );
+    buffer.push_back( static_cast<char>( value >> 8 ) );
+}
+
+void binary_writer::write_string( const std::string &value )
+{
+    write_varint( value.size() );
+    buffer += value;
+}
+
+void binary_writer::write_bytes( const std::string &bytes )
+{
+    buffer += bytes;
+}
+
+binary_reader::binary_reader( const char *begin, const char *end ) : pos( begin ), end( end )
+{
+}
+
+void binary_reader::require( const size_t bytes ) const
+{
+    if( static_cast<size_t>( end - pos ) < bytes ) {
+        throw std::runtime_error( "unexpected end of binary map data" );
+    }
+}
+
+uint64_t binary_reader::read_varint()
+{
+    uint64_t value = 0;
+    for( int shift = 0; shift < 64; shift += 7 ) {
+        require( 1 );
+        const uint8_t byte = static_cast<uint8_t>( *pos++ );
+        value |= static_cast<uint64_t>( byte & 0x7F ) << shift;
+        if( !( byte & 0x80 ) ) {
+            return value;
+        }
+    }
+    throw std::runtime_error( "malformed number in binary map data" );
+}
+
+int64_t binary_reader::read_signed()
+{
+    const uint64_t value = read_varint();
+    return static_cast<int64_t>( value >> 1 ) ^ -static_cast<int64_t>( value & 1 );
+}
+
+uint16_t binary_reader::read_uint16()
+{
+    require( 2 );
+    const uint16_t low = static_cast<uint8_t>( pos[0] );
+    const uint16_t high = static_cast<uint8_t>( pos[1] );
+    pos += 2;
+    return low | high << 8;
+}
+
+std::string binary_reader::read_string()
+{
+    const uint64_t size = read_varint();
+    require( size );
+    std::string result( pos, size );
+    pos += size;
+    return result;
+}
+
+bool binary_reader::skip_prefix( const std::string &bytes )
+{
+    if( static_cast<size_t>( end - pos ) < bytes.size() ||
+        bytes.compare( 0, bytes.size(), pos, bytes.size() ) != 0 ) {
+        return false;
+    }
+    pos += bytes.size();
+    return true;
+}
+
+uint16_t id_palette::index_of( const int int_id, const std::function<std::string()> &name )
+{
+    const size_t i = static_cast<size_t>( int_id );
+    if( i >= indices.size() ) {
+        indices.resize( i + 1, 0 );
+    }
+    if( indices[i] == 0 ) {
+        if( names.size() >= UINT16_MAX ) {
+            throw std::runtime_error( "too many distinct ids for a binary map palette" );
+        }
+        names.push_back( name() );
+        indices[i] = static_cast<uint16_t>( names.size() );
+    }
+    return indices[i] - 1;
+}
+
+void id_palette::write( binary_writer &out ) const
+{
+    out.write_varint( names.size() );
+    for( const std::string &name : names ) {
+        out.write_string( name );
+    }
+}
+
+template<typename Id, typename StrId>
+static std::vector<Id> read_palette( binary_reader &in )
+{
+    std::vector<Id> result;
+    const uint64_t count = in.read_varint();
+    for( uint64_t i = 0; i < count; ++i ) {
+        result.push_back( StrId( in.read_string() ).id() );
+    }
+    return result;
+}
+
+template<typename Id>
+static const Id &palette_entry( const std::vector<Id> &palette, const uint16_t index )
+{
+    if( index >= palette.size() ) {
+        throw std::runtime_error( "palette index out of range in binary map data" );
+    }
+    return palette[index];
+}
+
+bool is_binary_submap_data( const std::string &data )
+{
+    return data.compare( 0, submap_binary_magic.size(), submap_binary_magic ) == 0;
+}
+
+std::string submaps_to_binary( const std::vector<std::pair<tripoint, const submap *>> &submaps )
+{
+    // The palettes are only complete after all submaps have been encoded
+    submap_palettes palettes;
+    binary_writer body;
+    for( const std::pair<tripoint, const submap *> &sm : submaps ) {
+        body.write_signed( sm.first.x );
+        body.write_signed( sm.first.y );
+        body.write_signed( sm.first.z );
+        sm.second->store_binary( body, palettes );
+    }
+
+    binary_writer out;
+    out.write_bytes( submap_binary_magic );
+    out.write_varint( submap_binary_format_version );
+    out.write_varint( savegame_version );
+    palettes.ter.write( out );
+    palettes.furn.write( out );
+    palettes.trap.write( out );
+    out.write_varint( submaps.size() );
+    out.write_bytes( body.data() );
+    return out.data();
+}
+
+void submaps_from_binary( const std::string &data, const submap_consumer &add )
+{
+    binary_reader in( data.data(), data.data() + data.size() );
+    if( !in.skip_prefix( submap_binary_magic ) ) {
+        throw std::runtime_error( "not a binary map file" );
+    }
+    const uint64_t format_version = in.read_varint();
+    if( format_version != submap_binary_format_version ) {
+        throw std::runtime_error( "unsupported binary map format version " +
+                                  std::to_string( format_version ) );
+    }
+    const int version = static_cast<int>( in.read_varint() );
+    resolved_submap_palettes palettes;
+    palettes.ter = read_palette<ter_id, ter_str_id>( in );
+    palettes.furn = read_palette<furn_id, furn_str_id>( in );
+    palettes.trap = read_palette<trap_id, trap_str_id>( in );
+
+    const uint64_t count = in.read_varint();
+    for( uint64_t i = 0; i < count; ++i ) {
+        tripoint pos;
+        pos.x = static_cast<int>( in.read_signed() );
+        pos.y = static_cast<int>( in.read_signed() );
+        pos.z = static_cast<int>( in.read_signed() );
+        std::unique_ptr<submap> sm = std::make_unique<submap>();
+        sm->load_binary( in, palettes, version );
+        add( pos, sm );
+    }
+    if( !in.at_end() ) {
+        throw std::runtime_error( "trailing data after the last submap in binary map data" );
+    }
+}
+
+void submap::store_binary( binary_writer &out, submap_palettes &palettes ) const
+{
+    // Same tile order as the JSON format
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const ter_id &id = ter[i][j];
+            out.write_uint16( palettes.ter.index_of( id.to_i(), [&id]() {
+                return id.obj().id.str();
+            } ) );
+        }
+    }
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const furn_id &id = frn[i][j];
+            out.write_uint16( palettes.furn.index_of( id.to_i(), [&id]() {
+                return id.obj().id.str();
+            } ) );
+        }
+    }
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            const trap_id &id = trp[i][j];
+            out.write_uint16( palettes.trap.index_of( id.to_i(), [&id]() {
+                return id.id().str();
+            } ) );
+        }
+    }
+
+    std::vector<std::pair<int, int>> radiation_runs;
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            if( radiation_runs.empty() || radiation_runs.back().first != rad[i][j] ) {
+                radiation_runs.emplace_back( rad[i][j], 0 );
+            }
+            radiation_runs.back().second++;
+        }
+    }
+    out.write_varint( radiation_runs.size() );
+    for( const std::pair<int, int> &run : radiation_runs ) {
+        out.write_signed( run.first );
+        out.write_varint( run.second );
+    }
+
+    std::ostringstream contents;
+    JsonOut jsout( contents );
+    jsout.start_object();
+    store_contents( jsout );
+    jsout.end_object();
+    out.write_string( contents.str() );
+}
+
+void submap::load_binary( binary_reader &in, const resolved_submap_palettes &palettes,
+                          const int version )
+{
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            ter[i][j] = palette_entry( palettes.ter, in.read_uint16() );
+        }
+    }
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            frn[i][j] = palette_entry( palettes.furn, in.read_uint16() );
+        }
+    }
+    for( int j = 0; j < SEEY; j++ ) {
+        for( int i = 0; i < SEEX; i++ ) {
+            trp[i][j] = palette_entry( palettes.trap, in.read_uint16() );
+        }
+    }
+
+    const uint64_t num_runs = in.read_varint();
+    uint64_t rad_cell = 0;
+    for( uint64_t run = 0; run < num_runs; ++run ) {
+        const int value = static_cast<int>( in.read_signed() );
+        const uint64_t length = in.read_varint();
+        if( length > elements - rad_cell ) {
+            throw std::runtime_error( "radiation data overflows the submap in binary map data" );
+        }
+        for( uint64_t k = 0; k < length; ++k, ++rad_cell ) {
+            rad[rad_cell % SEEX][rad_cell / SEEX] = value;
+        }
+    }
+    if( rad_cell != elements ) {
+        throw std::runtime_error( "radiation data is incomplete in binary map data" );
+    }
+
+    const std::string contents = in.read_string();
+    JsonIn jsin( contents );
+    jsin.start_object();
+    while( !jsin.end_object() ) {
+        const std::string member_name = jsin.get_member_name();
+        load( jsin, member_name, version );
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#ifndef CATA_SRC_SUBMAP_BINARY_H
+#define CATA_SRC_SUBMAP_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "type_id.h"
+
+class submap;
+struct tripoint;
+
+/**
+ * Binary encoding of the map save files, which hold the submaps of one overmap terrain quad.
+ *
+ * Unless noted otherwise, integers are stored as LEB128 varints and signed ones are zigzag
+ * encoded first. A file consists of:
+ * - the bytes of @ref submap_binary_magic,
+ * - the format version and the savegame version,
+ * - the palettes of terrain, furniture and trap ids: a count, then each id as string,
+ * - the number of submaps, then for every submap:
+ *   - its coordinates (signed),
+ *   - its terrain, furniture and traps, as one little endian uint16 palette index per tile,
+ *   - its radiation as a count of runs, then value (signed) and length of each run,
+ *   - everything else as JSON object, see @ref submap::store_contents.
+ * Strings are stored as length followed by their bytes.
+ *
+ * Files written by older versions are JSON, they can be told apart by their first bytes.
+ */
+extern const std::string submap_binary_magic;
+
+/** Whether @p data (the start of a file is enough) is in the binary format. */
+bool is_binary_submap_data( const std::string &data );
+
+/** Encodes the given submaps as contents of a map save file. */
+std::string submaps_to_binary( const std::vector<std::pair<tripoint, const submap *>> &submaps );
+
+using submap_consumer = std::function<void( const tripoint &, std::unique_ptr<submap> & )>;
+
+/**
+ * Decodes the contents of a map save file written by @ref submaps_to_binary and hands every
+ * submap to @p add. Throws std::runtime_error if the data is malformed.
+ */
+void submaps_from_binary( const std::string &data, const submap_consumer &add );
+
+class binary_writer
+{
+    public:
+        void write_varint( uint64_t value );
+        void write_signed( int64_t value );
+        void write_uint16( uint16_t value );
+        void write_string( const std::string &value );
+        void write_bytes( const std::string &bytes );
+
+        const std::string &data() const {
+            return buffer;
+        }
+
+    private:
+        std::string buffer;
+};
+
+/** Reads from a buffer that must outlive it. Throws std::runtime_error when running out of data. */
+class binary_reader
+{
+    public:
+        binary_reader( const char *begin, const char *end );
+
+        uint64_t read_varint();
+        int64_t read_signed();
+        uint16_t read_uint16();
+        std::string read_string();
+        /** Consumes @p bytes if the data continues with them, returns whether it did. */
+        bool skip_prefix( const std::string &bytes );
+
+        bool at_end() const {
+            return pos == end;
+        }
+
+    private:
+        void require( size_t bytes ) const;
+
+        const char *pos;
+        const char *end;
+};
+
+/** Assigns consecutive indices to the ids written to one file. */
+class id_palette
+{
+    public:
+        /** Index of the id with the given int id, @p name is only called for new ids. */
+        uint16_t index_of( int int_id, const std::function<std::string()> &name );
+        void write( binary_writer &out ) const;
+
+    private:
+        // Index + 1 by int id, 0 if the id is not in the palette yet
+        std::vector<uint16_t> indices;
+        std::vector<std::string> names;
+};
+
+struct submap_palettes {
+    id_palette ter;
+    id_palette furn;
+    id_palette trap;
+};
+
+/** The palettes of a file that is being loaded, resolved to ids. */
+struct resolved_submap_palettes {
+    std::vector<ter_id> ter;
+    std::vector<furn_id> furn;
+    std::vector<trap_id> trap;
+};
+
+#endif // CATA_SRC_SUBMAP_BINARY_H
@@ -0,0 +1,112 @@
+#include "thread_pool.h"
+
+#include <memory>
+
+// Set on the threads of any pool, to run nested loops serially instead of deadlocking
+static thread_local bool in_worker = false;
+
+thread_pool::thread_pool( const int workers )
+{
+    threads.reserve( workers );
+    for( int i = 0; i < workers; ++i ) {
+        threads.emplace_back( &thread_pool::worker_loop, this );
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        stopping = true;
+    }
+    job_ready.notify_all();
+    for( std::thread &t : threads ) {
+        t.join();
+    }
+}
+
+void thread_pool::run_current_job()
+{
+    std::unique_lock<std::mutex> lock( mutex );
+    const std::function<void( int )> &f = *job;
+    while( next_index < end_index ) {
+        const int i = next_index++;
+        lock.unlock();
+        f( i );
+        lock.lock();
+    }
+}
+
+void thread_pool::worker_loop()
+{
+    in_worker = true;
+    int seen_generation = 0;
+    while( true ) {
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            job_ready.wait( lock, [&]() {
+                return stopping || job_generation != seen_generation;
+            } );
+            if( stopping ) {
+                return;
+            }
+            seen_generation = job_generation;
+        }
+        run_current_job();
+        {
+            std::lock_guard<std::mutex> lock( mutex );
+            --busy_workers;
+        }
+        job_done.notify_one();
+    }
+}
+
+void thread_pool::parallel_for( const int begin, const int end,
+                                const std::function<void( int )> &f )
+{
+    if( end - begin < 2 || threads.empty() || in_worker ) {
+        for( int i = begin; i < end; ++i ) {
+            f( i );
+        }
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if( running_job ) {
+            // Called from within f on the calling thread
+            for( int i = begin; i < end; ++i ) {
+                f( i );
+            }
+            return;
+        }
+        running_job = true;
+        job = &f;
+        next_index = begin;
+        end_index = end;
+        busy_workers = num_workers();
+        ++job_generation;
+    }
+    job_ready.notify_all();
+    run_current_job();
+
+    std::unique_lock<std::mutex> lock( mutex );
+    job_done.wait( lock, [this]() {
+        return busy_workers == 0;
+    } );
+    job = nullptr;
+    running_job = false;
+}
+
+thread_pool *get_thread_pool( const int threads )
+{
+    static std::unique_ptr<thread_pool> pool;
+    if( threads < 2 ) {
+        pool.reset();
+        return nullptr;
+    }
+    if( !pool || pool->num_workers() != threads - 1 ) {
+        pool.reset();
+        pool = std::make_unique<thread_pool>( threads - 1 );
+    }
+    return pool.get();
+}
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef CATA_SRC_THREAD_POOL_H
+#define CATA_SRC_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER)
+#   include "mingw.thread.h"
+#endif
+
+/**
+ * A fixed set of worker threads for data-parallel loops.
+ *
+ * The workers are started once and sleep between jobs, so handing them a loop is cheap
+ * enough to do every turn.  The thread calling @ref parallel_for works on the loop too
+ * and only one loop runs at a time.
+ *
+ * The loop body must not throw and must not call debugmsg or anything else that touches
+ * the UI, as it may run on a worker thread.
+ */
+class thread_pool
+{
+    public:
+        /** Starts a pool with the given number of extra threads besides the calling one. */
+        explicit thread_pool( int workers );
+        ~thread_pool();
+
+        thread_pool( const thread_pool & ) = delete;
+        thread_pool &operator=( const thread_pool & ) = delete;
+
+        int num_workers() const {
+            return static_cast<int>( threads.size() );
+        }
+
+        /**
+         * Calls f( i ) for every i in [begin, end), spread over the workers and the calling
+         * thread, and returns once all calls have finished.  The order of the calls is
+         * unspecified.  Nested calls (from within f) run serially on the calling thread.
+         */
+        void parallel_for( int begin, int end, const std::function<void( int )> &f );
+
+    private:
+        void worker_loop();
+        // Takes indices from the current job until none are left
+        void run_current_job();
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable job_ready;
+        std::condition_variable job_done;
+
+        // Everything below is guarded by mutex
+        const std::function<void( int )> *job = nullptr;
+        int next_index = 0;
+        int end_index = 0;
+        // Incremented for every job, so sleeping workers can tell a new one arrived
+        int job_generation = 0;
+        // Workers still working on the current job
+        int busy_workers = 0;
+        bool running_job = false;
+        bool stopping = false;
+};
+
+/**
+ * Shared pool with the given total number of threads (including the calling one),
+ * restarted when the count changes.  Returns nullptr for less than two threads, in which
+ * case the work should be done serially.  The count may only change on the main thread
+ * while no loop is running.
+ */
+thread_pool *get_thread_pool( int threads );
+
+#endif // CATA_SRC_THREAD_POOL_H
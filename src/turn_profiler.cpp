@@ -0,0 +1,130 @@
+#include "turn_profiler.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <ratio>
+
+#include "enum_conversions.h"
+#include "json.h"
+
+namespace io
+{
+
+template<>
+std::string enum_to_string<turn_profiler::phase>( turn_profiler::phase data )
+{
+    switch( data ) {
+        // *INDENT-OFF*
+        case turn_profiler::phase::scent_update: return "scent_update";
+        case turn_profiler::phase::build_floor_caches: return "build_floor_caches";
+        case turn_profiler::phase::vehmove: return "vehmove";
+        case turn_profiler::phase::process_fields: return "process_fields";
+        case turn_profiler::phase::process_items: return "process_items";
+        case turn_profiler::phase::process_sounds: return "process_sounds";
+        case turn_profiler::phase::build_map_cache: return "build_map_cache";
+        case turn_profiler::phase::monmove: return "monmove";
+        case turn_profiler::phase::update_bodytemp: return "update_bodytemp";
+        // *INDENT-ON*
+        case turn_profiler::phase::last:
+            break;
+    }
+    debugmsg( "Invalid turn_profiler::phase" );
+    abort();
+}
+
+} // namespace io
+
+namespace turn_profiler
+{
+
+static constexpr int num_phases = static_cast<int>( phase::last );
+
+// Options are also looked up from worker threads
+static std::atomic<bool> profiling_enabled( false );
+static int64_t turn_count = 0;
+static std::atomic<int64_t> option_lookup_count( 0 );
+static std::array<phase_stats, num_phases> stats;
+
+bool enabled()
+{
+    return profiling_enabled;
+}
+
+void set_enabled( bool enable )
+{
+    profiling_enabled = enable;
+}
+
+void reset()
+{
+    stats.fill( phase_stats() );
+    turn_count = 0;
+    option_lookup_count = 0;
+}
+
+void end_turn()
+{
+    if( profiling_enabled ) {
+        ++turn_count;
+    }
+}
+
+int64_t turns()
+{
+    return turn_count;
+}
+
+const phase_stats &get_stats( phase p )
+{
+    return stats[static_cast<int>( p )];
+}
+
+void record( phase p, std::chrono::nanoseconds elapsed )
+{
+    phase_stats &s = stats[static_cast<int>( p )];
+    s.total += elapsed;
+    s.worst = std::max( s.worst, elapsed );
+    ++s.calls;
+}
+
+void count_option_lookup()
+{
+    if( profiling_enabled ) {
+        ++option_lookup_count;
+    }
+}
+
+int64_t option_lookups()
+{
+    return option_lookup_count;
+}
+
+void serialize( JsonOut &jsout )
+{
+    using ms = std::chrono::duration<double, std::milli>;
+    using us = std::chrono::duration<double, std::micro>;
+
+    jsout.start_object();
+    jsout.member( "turns", turn_count );
+    jsout.member( "option_lookups_per_turn", turn_count > 0 ?
+                  static_cast<double>( option_lookup_count.load() ) / turn_count : 0.0 );
+    jsout.member( "phases" );
+    jsout.start_object();
+    for( int i = 0; i < num_phases; ++i ) {
+        const phase p = static_cast<phase>( i );
+        const phase_stats &s = stats[i];
+        jsout.member( io::enum_to_string( p ) );
+        jsout.start_object();
+        jsout.member( "total_ms", ms( s.total ).count() );
+        jsout.member( "mean_us", s.calls > 0 ? us( s.total ).count() / s.calls : 0.0 );
+        jsout.member( "worst_us", us( s.worst ).count() );
+        jsout.member( "calls", s.calls );
+        jsout.end_object();
+    }
+    jsout.end_object();
+    jsout.end_object();
+}
+
+} // namespace turn_profiler
@@ -0,0 +1,94 @@
+#pragma once
+#ifndef CATA_SRC_TURN_PROFILER_H
+#define CATA_SRC_TURN_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "enum_traits.h"
+
+class JsonOut;
+
+/**
+ * Lightweight wall-clock accounting for the expensive phases of @ref game::do_turn.
+ *
+ * Profiling is disabled by default, in which case a @ref turn_profiler::scoped_phase
+ * costs a single branch.  When enabled (by the turn loop benchmark in the test suite,
+ * or by anything else that wants the numbers) every phase accumulates its total time,
+ * call count and worst single call until @ref turn_profiler::reset is called.
+ */
+namespace turn_profiler
+{
+
+enum class phase : int {
+    scent_update,
+    build_floor_caches,
+    vehmove,
+    process_fields,
+    process_items,
+    process_sounds,
+    build_map_cache,
+    monmove,
+    update_bodytemp,
+    last
+};
+
+struct phase_stats {
+    std::chrono::nanoseconds total{ 0 };
+    std::chrono::nanoseconds worst{ 0 };
+    int64_t calls = 0;
+};
+
+bool enabled();
+void set_enabled( bool enable );
+/** Clears all accumulated statistics and the turn counter. */
+void reset();
+/** Marks the end of a turn, used for the per-turn averages in the report. */
+void end_turn();
+int64_t turns();
+
+const phase_stats &get_stats( phase p );
+void record( phase p, std::chrono::nanoseconds elapsed );
+
+/** Counts a lookup of an option by its name, which @ref option_handle avoids. */
+void count_option_lookup();
+int64_t option_lookups();
+
+/**
+ * Writes the collected statistics as a JSON object:
+ * { "turns": N, "option_lookups_per_turn": X,
+ *   "phases": { "<phase>": { "total_ms", "mean_us", "worst_us", "calls" }, ... } }
+ */
+void serialize( JsonOut &jsout );
+
+/** RAII helper attributing the wall time of its lifetime to the given phase. */
+class scoped_phase
+{
+    public:
+        explicit scoped_phase( phase p ) : which( p ), active( enabled() ) {
+            if( active ) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+        scoped_phase( const scoped_phase & ) = delete;
+        scoped_phase &operator=( const scoped_phase & ) = delete;
+        ~scoped_phase() {
+            if( active ) {
+                record( which, std::chrono::steady_clock::now() - start );
+            }
+        }
+    private:
+        phase which;
+        bool active;
+        std::chrono::steady_clock::time_point start;
+};
+
+} // namespace turn_profiler
+
+template<>
+struct enum_traits<turn_profiler::phase> {
+    static constexpr turn_profiler::phase last = turn_profiler::phase::last;
+};
+
+#endif // CATA_SRC_TURN_PROFILER_H
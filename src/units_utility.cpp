@@ -7,6 +7,11 @@
 #include "string_formatter.h"
 #include "translations.h"
 
+static const option_handle<std::string> distance_units( "DISTANCE_UNITS" );
+static const option_handle<std::string> use_metric_speeds( "USE_METRIC_SPEEDS" );
+static const option_handle<std::string> use_metric_weights( "USE_METRIC_WEIGHTS" );
+static const option_handle<std::string> volume_units( "VOLUME_UNITS" );
+
 units::angle normalize( units::angle a, const units::angle &mod )
 {
     a = units::fmod( a, mod );
@@ -18,12 +23,12 @@ units::angle normalize( units::angle a, const units::angle &mod )
 
 const char *weight_units()
 {
-    return get_option<std::string>( "USE_METRIC_WEIGHTS" ) == "lbs" ? _( "lbs" ) : _( "kg" );
+    return use_metric_weights.value() == "lbs" ? _( "lbs" ) : _( "kg" );
 }
 
 const char *volume_units_abbr()
 {
-    const std::string vol_units = get_option<std::string>( "VOLUME_UNITS" );
+    const std::string &vol_units = volume_units.value();
     if( vol_units == "c" ) {
         return pgettext( "Volume unit", "c" );
     } else if( vol_units == "l" ) {
@@ -35,7 +40,7 @@ const char *volume_units_abbr()
 
 const char *volume_units_long()
 {
-    const std::string vol_units = get_option<std::string>( "VOLUME_UNITS" );
+    const std::string &vol_units = volume_units.value();
     if( vol_units == "c" ) {
         return _( "cup" );
     } else if( vol_units == "l" ) {
@@ -47,7 +52,7 @@ const char *volume_units_long()
 
 double convert_velocity( int velocity, const units_type vel_units )
 {
-    const std::string type = get_option<std::string>( "USE_METRIC_SPEEDS" );
+    const std::string &type = use_metric_speeds.value();
     // internal units to mph conversion
     double ret = static_cast<double>( velocity ) / 100;
 
@@ -71,7 +76,7 @@ double convert_velocity( int velocity, const units_type vel_units )
 double convert_weight( const units::mass &weight )
 {
     double ret = to_gram( weight );
-    if( get_option<std::string>( "USE_METRIC_WEIGHTS" ) == "kg" ) {
+    if( use_metric_weights.value() == "kg" ) {
         ret /= 1000;
     } else {
         ret /= 453.6;
@@ -83,7 +88,7 @@ double convert_length_cm_in( const units::length &length )
 {
 
     double ret = to_millimeter( length );
-    const bool metric = get_option<std::string>( "DISTANCE_UNITS" ) == "metric";
+    const bool metric = distance_units.value() == "metric";
     if( metric ) {
         ret /= 10;
     } else {
@@ -97,7 +102,7 @@ double convert_length_cm_in( const units::length &length )
 int convert_length( const units::length &length )
 {
     int ret = to_millimeter( length );
-    const bool metric = get_option<std::string>( "DISTANCE_UNITS" ) == "metric";
+    const bool metric = distance_units.value() == "metric";
     if( metric ) {
         if( ret % 1'000'000 == 0 ) {
             // kilometers
@@ -127,7 +132,7 @@ int convert_length( const units::length &length )
 std::string length_units( const units::length &length )
 {
     int length_mm = to_millimeter( length );
-    const bool metric = get_option<std::string>( "DISTANCE_UNITS" ) == "metric";
+    const bool metric = distance_units.value() == "metric";
     if( metric ) {
         if( length_mm % 1'000'000 == 0 ) {
             //~ kilometers
@@ -181,7 +186,7 @@ double convert_volume( int volume, int *out_scale )
 {
     double ret = volume;
     int scale = 0;
-    const std::string vol_units = get_option<std::string>( "VOLUME_UNITS" );
+    const std::string &vol_units = volume_units.value();
     if( vol_units == "c" ) {
         ret *= 0.004;
         scale = 1;
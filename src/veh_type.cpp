@@ -551,6 +551,19 @@ void vpart_info::finalize()
             e.second.set_flag( "FOLDABLE" );
         }
 
+        // add the base item to the installation requirements
+        // TODO: support multiple/alternative base items
+        requirement_data ins;
+        ins.components.push_back( { { { e.second.base_item, 1 } } } );
+
+        const requirement_id ins_id( std::string( "inline_vehins_base_" ) + e.second.id.str() );
+        requirement_data::save_requirement( ins, ins_id );
+        e.second.install_reqs.emplace_back( ins_id, 1 );
+
+        if( e.second.removal_moves < 0 ) {
+            e.second.removal_moves = e.second.install_moves / 2;
+        }
+
         for( const auto &f : e.second.flags ) {
             auto b = vpart_bitflag_map.find( f );
             if( b != vpart_bitflag_map.end() ) {
@@ -614,19 +627,6 @@ void vpart_info::check()
     for( auto &vp : vpart_info_all ) {
         auto &part = vp.second;
 
-        // add the base item to the installation requirements
-        // TODO: support multiple/alternative base items
-        requirement_data ins;
-        ins.components.push_back( { { { part.base_item, 1 } } } );
-
-        const requirement_id ins_id( std::string( "inline_vehins_base_" ) + part.id.str() );
-        requirement_data::save_requirement( ins, ins_id );
-        part.install_reqs.emplace_back( ins_id, 1 );
-
-        if( part.removal_moves < 0 ) {
-            part.removal_moves = part.install_moves / 2;
-        }
-
         for( auto &e : part.install_skills ) {
             if( !e.first.is_valid() ) {
                 debugmsg( "vehicle part %s has unknown install skill %s", part.id.c_str(), e.first.c_str() );
@@ -626,10 +626,11 @@ std::string print_temperature( double fahrenheit, int decimals )
         return string_format( "%.*f", decimals, value );
     };
 
-    if( get_option<std::string>( "USE_CELSIUS" ) == "celsius" ) {
+    static const option_handle<std::string> use_celsius( "USE_CELSIUS" );
+    if( use_celsius.value() == "celsius" ) {
         return string_format( pgettext( "temperature in Celsius", "%sC" ),
                               text( temp_to_celsius( fahrenheit ) ) );
-    } else if( get_option<std::string>( "USE_CELSIUS" ) == "kelvin" ) {
+    } else if( use_celsius.value() == "kelvin" ) {
         return string_format( pgettext( "temperature in Kelvin", "%sK" ),
                               text( temp_to_kelvin( fahrenheit ) ) );
     } else {
@@ -23,6 +23,7 @@
 #include "game.h"
 #include "input.h"
 #include "json.h"
+#include "mapbuffer.h"
 #include "mod_manager.h"
 #include "name.h"
 #include "output.h"
@@ -1636,6 +1637,10 @@ static bool isForbidden( const std::string &candidate )
 
 void worldfactory::delete_world( const std::string &worldname, const bool delete_folder )
 {
+    // Don't let map files that are still being written recreate the folder, or still be open
+    MAPBUFFER.wait_for_pending_save();
+    MAPBUFFER.finish_prefetch();
+    MAPBUFFER.close_region_files();
     std::string worldpath = get_world( worldname )->folder_path();
     std::set<std::string> directory_paths;
 
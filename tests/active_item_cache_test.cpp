@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <map>
 #include <set>
 
+#include "active_item_cache.h"
+
 #include "calendar.h"
 #include "cata_catch.h"
 #include "game_constants.h"
@@ -7,6 +13,7 @@
 #include "map.h"
 #include "map_helpers.h"
 #include "point.h"
+#include "safe_reference.h"
 
 TEST_CASE( "place_active_item_at_various_coordinates", "[item]" )
 {
@@ -45,3 +52,97 @@ TEST_CASE( "place_active_item_at_various_coordinates", "[item]" )
         }
     }
 }
+
+// How often each item is returned by active_item_cache::get_for_processing() in the given calls
+static std::map<const item *, int> count_processing( active_item_cache &cache, int calls )
+{
+    std::map<const item *, int> processed;
+    for( int turn = 0; turn < calls; ++turn ) {
+        for( const item_reference &ref : cache.get_for_processing() ) {
+            processed[ref.item_ref.get()]++;
+        }
+    }
+    return processed;
+}
+
+TEST_CASE( "active_item_cache_processes_items_in_turn", "[item]" )
+{
+    active_item_cache cache;
+    std::list<item> items;
+    for( int i = 0; i < 10; ++i ) {
+        items.emplace_back( "firecracker_act", calendar::turn_zero, item::default_charges_tag() );
+        items.emplace_back( "apple" );
+    }
+    for( item &it : items ) {
+        cache.add( it, point( 1, 2 ) );
+        // A second reference to the same item is not added
+        cache.add( it, point( 1, 2 ) );
+    }
+    REQUIRE( cache.get().size() == items.size() );
+
+    // Ten items of each speed, returned size / speed + 1 at a time
+    const int slow_speed = items.back().processing_speed();
+    REQUIRE( slow_speed > 10 );
+    std::map<const item *, int> processed = count_processing( cache, slow_speed );
+    for( const item &it : items ) {
+        const int per_call = std::min( 10 / it.processing_speed() + 1, 10 );
+        CHECK( processed[&it] == slow_speed * per_call / 10 );
+    }
+
+    // Removed and destroyed items are no longer returned
+    cache.remove( &items.front() );
+    items.pop_back();
+    items.pop_front();
+    CHECK( cache.get().size() == items.size() );
+    processed = count_processing( cache, slow_speed );
+    CHECK( processed.size() == items.size() );
+
+    for( const item &it : items ) {
+        cache.remove( &it );
+    }
+    CHECK( cache.empty() );
+}
+
+TEST_CASE( "active_item_cache_processes_few_slow_items_every_few_turns", "[item]" )
+{
+    active_item_cache cache;
+    std::list<item> items;
+    items.emplace_back( "apple" );
+    const int speed = items.front().processing_speed();
+    REQUIRE( speed > 100 );
+    cache.add( items.front(), point_zero );
+
+    // A lone item is processed on every call, like a corpse that may revive
+    std::map<const item *, int> processed = count_processing( cache, 5 );
+    CHECK( processed[&items.front()] == 5 );
+
+    // Few items take turns, each is processed every few calls
+    for( int i = 0; i < 4; ++i ) {
+        items.emplace_back( "apple" );
+        cache.add( items.back(), point_zero );
+    }
+    processed = count_processing( cache, 50 );
+    for( const item &it : items ) {
+        CHECK( processed[&it] == 10 );
+    }
+
+    // Items removed in the middle of a round do not make the others wait longer
+    cache.remove( &*std::next( items.begin() ) );
+    items.erase( std::next( items.begin() ) );
+    processed = count_processing( cache, 40 );
+    for( const item &it : items ) {
+        CHECK( processed[&it] == 10 );
+    }
+
+    // With many items each is processed a bit more often than once per processing speed
+    for( int i = 0; i < speed; ++i ) {
+        items.emplace_back( "apple" );
+        cache.add( items.back(), point_zero );
+    }
+    const int count = static_cast<int>( items.size() );
+    const int per_call = count / speed + 1;
+    processed = count_processing( cache, count );
+    for( const item &it : items ) {
+        CHECK( processed[&it] == per_call );
+    }
+}
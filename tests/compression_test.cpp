@@ -0,0 +1,147 @@
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cata_catch.h"
+#include "cata_utility.h"
+#include "compression.h"
+#include "filesystem.h"
+#include "game_constants.h"
+#include "json.h"
+#include "path_info.h"
+#include "point.h"
+#include "submap.h"
+#include "type_id.h"
+
+static std::string test_file_path()
+{
+    return PATH_INFO::savedir() + "compression_test.json";
+}
+
+static std::string read_test_file()
+{
+    std::string result;
+    REQUIRE( read_from_file( test_file_path(), [&result]( std::istream & fin ) {
+        std::ostringstream data;
+        data << fin.rdbuf();
+        result = data.str();
+    } ) );
+    return result;
+}
+
+TEST_CASE( "compressed_data_round_trip", "[compression]" )
+{
+    std::string data;
+    for( int i = 0; i < 100000; ++i ) {
+        data += "{\"typeid\":\"t_dirt\",\"count\":" + std::to_string( i ) + "},";
+    }
+    const std::string compressed = compress_data( data );
+    CHECK( is_compressed_data( compressed ) );
+    CHECK_FALSE( is_compressed_data( data ) );
+    CHECK( compressed.size() * 5 < data.size() );
+    CHECK( decompress_data( compressed ) == data );
+    CHECK( decompress_data( compress_data( "" ) ).empty() );
+
+    CHECK_THROWS_AS( decompress_data( compressed.substr( 0, compressed.size() / 2 ) ),
+                     std::runtime_error );
+}
+
+TEST_CASE( "read_from_file_detects_compression", "[compression]" )
+{
+    const std::string data = "[ \"some json\", 1, 2, 3 ]";
+    const auto writer = [&data]( std::ostream & fout ) {
+        fout << data;
+    };
+
+    SECTION( "uncompressed" ) {
+        write_to_file( test_file_path(), writer );
+        CHECK( read_entire_file( test_file_path() ) == data );
+        CHECK( read_test_file() == data );
+    }
+    SECTION( "compressed" ) {
+        write_to_file( test_file_path(), writer, file_compression::deflate );
+        CHECK( is_compressed_data( read_entire_file( test_file_path() ) ) );
+        CHECK( read_test_file() == data );
+        // Readers may seek around in the data
+        CHECK( read_from_file_json( test_file_path(), []( JsonIn & jsin ) {
+            JsonArray arr = jsin.get_array();
+            CHECK( arr.get_string( 0 ) == "some json" );
+            CHECK( arr.get_int( 3 ) == 3 );
+        } ) );
+    }
+    remove_file( test_file_path() );
+}
+
+// A sample of map data as it is saved, in the format of the legacy map files
+static std::string sample_map_json()
+{
+    const std::vector<ter_id> terrain = {
+        ter_id( "t_dirt" ), ter_id( "t_grass" ), ter_id( "t_floor" ), ter_id( "t_wall" ),
+        ter_id( "t_pavement" )
+    };
+    const int terrain_count = static_cast<int>( terrain.size() );
+    std::ostringstream map_json;
+    JsonOut jsout( map_json );
+    jsout.start_array();
+    for( int i = 0; i < 256; ++i ) {
+        submap sm;
+        for( int x = 0; x < SEEX; ++x ) {
+            for( int y = 0; y < SEEY; ++y ) {
+                // Patches of terrain like in generated maps, with some noise
+                const int patch = ( x / 4 + y / 3 + i ) % terrain_count;
+                const int noise = ( x * 7 + y * 13 + i * 31 ) % 11 == 0 ? 1 : 0;
+                sm.set_ter( point( x, y ), terrain[( patch + noise ) % terrain_count] );
+                sm.set_radiation( point( x, y ), ( x * y + i ) % 3 == 0 ? i % 5 : 0 );
+            }
+        }
+        jsout.start_object();
+        jsout.member( "version", 0 );
+        jsout.member( "coordinates" );
+        jsout.start_array();
+        jsout.write( i % 16 );
+        jsout.write( i / 16 );
+        jsout.write( 0 );
+        jsout.end_array();
+        sm.store( jsout );
+        jsout.end_object();
+    }
+    jsout.end_array();
+    return map_json.str();
+}
+
+// Run with "[compression][benchmark]" for the save and load times. The sizes are printed too.
+TEST_CASE( "save_file_compression_benchmark", "[.][compression][benchmark]" )
+{
+    const std::string data = sample_map_json();
+    const auto writer = [&data]( std::ostream & fout ) {
+        fout << data;
+    };
+    const auto reader = []( std::istream & fin ) {
+        std::ostringstream read;
+        read << fin.rdbuf();
+    };
+
+    write_to_file( test_file_path(), writer );
+    const size_t plain_size = read_entire_file( test_file_path() ).size();
+    BENCHMARK( "save uncompressed" ) {
+        return write_to_file( test_file_path(), writer, "benchmark file" );
+    };
+    BENCHMARK( "load uncompressed" ) {
+        return read_from_file( test_file_path(), reader );
+    };
+
+    write_to_file( test_file_path(), writer, file_compression::deflate );
+    const size_t compressed_size = read_entire_file( test_file_path() ).size();
+    BENCHMARK( "save compressed" ) {
+        return write_to_file( test_file_path(), writer, "benchmark file",
+                              file_compression::deflate );
+    };
+    BENCHMARK( "load compressed" ) {
+        return read_from_file( test_file_path(), reader );
+    };
+
+    WARN( "uncompressed: " << plain_size << " bytes, compressed: " << compressed_size
+          << " bytes" );
+    remove_file( test_file_path() );
+}
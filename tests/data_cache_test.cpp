@@ -0,0 +1,170 @@
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "avatar.h"
+#include "cata_catch.h"
+#include "cata_utility.h"
+#include "data_cache.h"
+#include "filesystem.h"
+#include "game.h"
+#include "init.h"
+#include "loading_ui.h"
+#include "map_helpers.h"
+#include "path_info.h"
+#include "pldata.h"
+#include "requirements.h"
+#include "scenario.h"
+#include "string_formatter.h"
+#include "type_id.h"
+#include "veh_type.h"
+
+static std::string write_data_file( const std::string &path, const std::string &data )
+{
+    write_to_file( path, [&data]( std::ostream & fout ) {
+        fout << data;
+    } );
+    return path;
+}
+
+static uint64_t key_of( const std::vector<std::string> &files )
+{
+    std::vector<uint64_t> hashes;
+    for( const std::string &file : files ) {
+        hashes.push_back( data_cache::content_hash( read_entire_file( file ) ) );
+    }
+    return data_cache::files_key( files, hashes );
+}
+
+/** Keeps the cache in a scratch directory instead of the one of the user directory. */
+class scratch_data_cache
+{
+    public:
+        scratch_data_cache() : dir( PATH_INFO::savedir() + "data_cache_test/" ) {
+            remove_files();
+            REQUIRE( assure_dir_exist( dir ) );
+            data_cache::set_directory( dir );
+        }
+        ~scratch_data_cache() {
+            data_cache::set_directory( "" );
+            remove_files();
+            remove_directory( dir );
+        }
+        const std::string dir;
+    private:
+        void remove_files() {
+            for( const std::string &file : get_files_from_path( "", dir, true, true ) ) {
+                remove_file( file );
+            }
+        }
+};
+
+TEST_CASE( "data_cache_keys_data_by_contents", "[data_cache]" )
+{
+    scratch_data_cache cache;
+    const std::vector<std::string> files = {
+        write_data_file( cache.dir + "a.json", "[ { \"type\": \"a\" } ]" ),
+        write_data_file( cache.dir + "b.json", "{ \"type\": \"b\" }" ),
+    };
+    const uint64_t key = key_of( files );
+    CHECK( key_of( files ) == key );
+    CHECK( key_of( { files[0] } ) != key );
+
+    // Changing a file changes the key, even if its size stays the same
+    write_data_file( files[1], "{ \"type\": \"c\" }" );
+    const uint64_t changed_key = key_of( files );
+    CHECK( changed_key != key );
+
+    const uint64_t combined = data_cache::combine_keys( key, changed_key );
+    CHECK( combined != data_cache::combine_keys( changed_key, key ) );
+    CHECK_FALSE( data_cache::was_checked( combined ) );
+    data_cache::set_checked( combined );
+    CHECK( data_cache::was_checked( combined ) );
+    CHECK_FALSE( data_cache::was_checked( combined + 1 ) );
+    CHECK( file_exist( cache.dir + "checked" ) );
+
+    data_cache::clear_checked();
+    CHECK_FALSE( data_cache::was_checked( combined ) );
+}
+
+TEST_CASE( "data_cache_keeps_only_recent_keys", "[data_cache]" )
+{
+    scratch_data_cache cache;
+    for( uint64_t key = 1; key <= 100; ++key ) {
+        data_cache::set_checked( key );
+    }
+    // Checking it again makes it recent
+    data_cache::set_checked( 90 );
+    // Ten new keys push out the ten oldest ones
+    for( uint64_t key = 1000; key < 1010; ++key ) {
+        data_cache::set_checked( key );
+    }
+    CHECK( data_cache::was_checked( 90 ) );
+    CHECK( data_cache::was_checked( 100 ) );
+    CHECK_FALSE( data_cache::was_checked( 1 ) );
+    CHECK_FALSE( data_cache::was_checked( 80 ) );
+    CHECK_FALSE( data_cache::was_checked( 95 ) );
+    CHECK( read_entire_file( cache.dir + "checked" ).size() < 1000 );
+}
+
+// What the game uses of the vehicle parts, as text to compare it across loads
+static std::map<vpart_id, std::string> describe_vehicle_parts()
+{
+    std::map<vpart_id, std::string> ret;
+    for( const std::pair<const vpart_id, vpart_info> &vp : vpart_info::all() ) {
+        const vpart_info &part = vp.second;
+        ret[vp.first] = string_format( "install %d moves: %s\nremoval %d moves: %s",
+                                       part.install_moves, part.install_requirements().list_all(),
+                                       part.removal_moves, part.removal_requirements().list_all() );
+    }
+    return ret;
+}
+
+// Loads the game data again, like the test setup does.  Nothing may refer to the old data.
+static void reload_game_data()
+{
+    loading_ui ui( false );
+    g->load_core_data( ui );
+    g->load_world_modfiles( ui );
+}
+
+TEST_CASE( "data_cache_skipping_the_checks_loads_the_same_data", "[data_cache]" )
+{
+    scratch_data_cache cache;
+    const data_cache::cache_mode previous_mode = data_cache::mode();
+    const scenario *const previous_scenario = get_scenario();
+    const string_id<scenario> scenario_id = previous_scenario != nullptr ?
+                                            previous_scenario->ident() : string_id<scenario>();
+    clear_map();
+    clear_vehicles();
+    get_avatar() = avatar();
+    data_cache::set_mode( data_cache::cache_mode::enabled );
+
+    // The first load runs the checks and records the data, the second one skips them
+    reload_game_data();
+    const uint64_t key = DynamicDataLoader::get_instance().data_cache_key();
+    REQUIRE( data_cache::was_checked( key ) );
+    const std::map<vpart_id, std::string> checked_parts = describe_vehicle_parts();
+    reload_game_data();
+    CHECK( DynamicDataLoader::get_instance().data_cache_key() == key );
+    const std::map<vpart_id, std::string> unchecked_parts = describe_vehicle_parts();
+
+    data_cache::set_mode( previous_mode );
+    if( previous_scenario != nullptr ) {
+        set_scenario( &scenario_id.obj() );
+    }
+    get_avatar().create( character_type::NOW );
+    get_avatar().setID( g->assign_npc_id(), false );
+
+    REQUIRE( checked_parts.size() == unchecked_parts.size() );
+    for( const std::pair<const vpart_id, std::string> &part : checked_parts ) {
+        CAPTURE( part.first.str() );
+        const auto unchecked = unchecked_parts.find( part.first );
+        REQUIRE( unchecked != unchecked_parts.end() );
+        CHECK( unchecked->second == part.second );
+        // The base item is part of the installation requirements
+        CHECK( requirement_id( "inline_vehins_base_" + part.first.str() ).is_valid() );
+        CHECK( vpart_info::all().at( part.first ).removal_moves >= 0 );
+    }
+}
@@ -1,4 +1,5 @@
 #include <iosfwd>
+#include <memory>
 #include <vector>
 
 #include "avatar.h"
@@ -13,6 +14,7 @@
 #include "mapdata.h"
 #include "player_helpers.h"
 #include "point.h"
+#include "submap.h"
 #include "type_id.h"
 
 static int count_fields( const field_type_str_id &field_type )
@@ -463,3 +465,32 @@ TEST_CASE( "field API test", "[field]" )
 
     fields_test_cleanup();
 }
+
+TEST_CASE( "submap_lists_the_tiles_with_fields", "[field]" )
+{
+    std::unique_ptr<submap> sm = std::make_unique<submap>();
+    CHECK( sm->get_field_tiles().empty() );
+
+    CHECK( sm->add_field( { 3, 4 }, fd_fire, 1, 0_turns ) );
+    CHECK_FALSE( sm->add_field( { 3, 4 }, fd_fire, 1, 0_turns ) );
+    CHECK( sm->add_field( { 3, 4 }, fd_smoke, 1, 0_turns ) );
+    CHECK( sm->add_field( { 1, 2 }, fd_smoke, 1, 0_turns ) );
+    CHECK( sm->field_count == 3 );
+    CHECK( sm->get_field_tiles() == std::vector<point>{ { 3, 4 }, { 1, 2 } } );
+
+    // Tiles stay listed until the next update
+    sm->get_field( { 3, 4 } ).clear();
+    CHECK( sm->get_field_tiles().size() == 2 );
+    sm->add_field( { 5, 0 }, fd_smoke, 1, 0_turns );
+    sm->update_field_tiles();
+    CHECK( sm->get_field_tiles() == std::vector<point>{ { 1, 2 }, { 5, 0 } } );
+
+    sm->rotate( 1 );
+    const point rotated = point( 1, 2 ).rotate( 1, { SEEX, SEEY } );
+    CHECK( sm->get_field( rotated ).find_field( fd_smoke ) );
+    sm->update_field_tiles();
+    CHECK( sm->get_field_tiles().front() == rotated );
+    // Listing a rotated tile again does not duplicate it
+    sm->add_field( rotated, fd_fire, 1, 0_turns );
+    CHECK( sm->get_field_tiles().size() == 2 );
+}
@@ -2,6 +2,8 @@
 #include <array>
 #include <functional>
 #include <iterator>
+#include <locale>
+#include <limits>
 #include <list>
 #include <map>
 #include <set>
@@ -21,10 +23,12 @@
 #include "item.h"
 #include "json.h"
 #include "magic.h"
+#include "mapbuffer.h"
 #include "mutation.h"
 #include "optional.h"
 #include "sounds.h"
 #include "string_formatter.h"
+#include "submap.h"
 #include "translations.h"
 #include "type_id.h"
 
@@ -487,12 +491,15 @@ TEST_CASE( "translation_text_style_check_error_recovery", "[json][translation]"
     }
 }
 
+// Reading from a stream and reading from memory must give the same results and errors
 static void test_get_string( const std::string &str, const std::string &json )
 {
     CAPTURE( json );
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK( jsin.get_string() == str );
+    JsonIn jsin_buffer( json );
+    CHECK( jsin_buffer.get_string() == str );
 }
 
 template<typename Matcher>
@@ -502,6 +509,8 @@ static void test_get_string_throws_matches( Matcher &&matcher, const std::string
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK_THROWS_MATCHES( jsin.get_string(), JsonError, matcher );
+    JsonIn jsin_buffer( json );
+    CHECK_THROWS_MATCHES( jsin_buffer.get_string(), JsonError, matcher );
 }
 
 template<typename Matcher>
@@ -513,6 +522,8 @@ static void test_string_error_throws_matches( Matcher &&matcher, const std::stri
     std::istringstream iss( json );
     JsonIn jsin( iss );
     CHECK_THROWS_MATCHES( jsin.string_error( "<message>", offset ), JsonError, matcher );
+    JsonIn jsin_buffer( json );
+    CHECK_THROWS_MATCHES( jsin_buffer.string_error( "<message>", offset ), JsonError, matcher );
 }
 
 TEST_CASE( "jsonin_get_string", "[json]" )
@@ -703,6 +714,234 @@ TEST_CASE( "jsonin_get_string", "[json]" )
         R"("foo\nbar")", 5 );
 }
 
+TEST_CASE( "jsonin_reads_from_memory", "[json]" )
+{
+    const std::string json = R"({
+        "id": "test",
+        "skipped": { "a": [ 1, -2.5e3, "x\"y", true, false, null ], "b": {} },
+        "name": "café",
+        "escaped": "a\tb",
+        "count": 42
+    })";
+    JsonIn jsin( json );
+    JsonObject jo = jsin.get_object();
+    CHECK( jsin.tell() == static_cast<int>( json.size() ) );
+    jo.allow_omitted_members();
+    CHECK( jo.get_string( "id" ) == "test" );
+    CHECK( jo.get_string( "name" ) == "café" );
+    CHECK( jo.get_string( "escaped" ) == "a\tb" );
+    CHECK( jo.get_int( "count" ) == 42 );
+    JsonArray skipped = jo.get_object( "skipped" ).get_array( "a" );
+    CHECK( skipped.get_float( 1 ) == -2500 );
+    CHECK( skipped.get_string( 2 ) == "x\"y" );
+    CHECK( skipped.get_bool( 3 ) );
+
+    // Trailing data after the top level value is reported like it is for streams
+    const std::string trailing = R"([ 1, 2 ] 3)";
+    std::istringstream iss( trailing );
+    JsonIn jsin_stream( iss );
+    JsonIn jsin_buffer( trailing );
+    std::string stream_error;
+    std::string buffer_error;
+    try {
+        jsin_stream.skip_value();
+    } catch( const JsonError &err ) {
+        stream_error = err.what();
+    }
+    try {
+        jsin_buffer.skip_value();
+    } catch( const JsonError &err ) {
+        buffer_error = err.what();
+    }
+    CHECK_FALSE( stream_error.empty() );
+    CHECK( buffer_error == stream_error );
+}
+
+TEST_CASE( "jsonobject_member_index", "[json]" )
+{
+    const std::string json = R"({ "zeta": 1, "alpha": 2, "mid": 3, "// comment": 4 })";
+
+    SECTION( "members are found and iterated in name order" ) {
+        JsonIn jsin( json );
+        JsonObject jo = jsin.get_object();
+        CHECK( jo.size() == 4 );
+        CHECK( jo.has_member( "mid" ) );
+        CHECK_FALSE( jo.has_member( "beta" ) );
+        CHECK( jo.get_int( "zeta" ) == 1 );
+        CHECK( jo.get_int( "alpha" ) == 2 );
+        std::vector<std::string> names;
+        for( const JsonMember member : jo ) {
+            names.push_back( member.name() );
+        }
+        CHECK( names == std::vector<std::string> { "// comment", "alpha", "mid", "zeta" } );
+    }
+
+    SECTION( "unvisited members are reported" ) {
+        const std::string error = capture_debugmsg_during( [&json]() {
+            JsonIn jsin( json );
+            JsonObject jo = jsin.get_object();
+            CHECK( jo.get_int( "alpha" ) == 2 );
+            CHECK( jo.get_int( "missing", 5 ) == 5 );
+            jo.finish();
+        } );
+        CHECK( error.find( "field name \"mid\"" ) != std::string::npos );
+        CHECK( error.find( "field name \"zeta\"" ) != std::string::npos );
+        CHECK( error.find( "field name \"alpha\"" ) == std::string::npos );
+        CHECK( error.find( "field name \"// comment\"" ) == std::string::npos );
+    }
+
+    SECTION( "visited members are copied by name" ) {
+        JsonIn jsin( json );
+        JsonObject jo = jsin.get_object();
+        JsonObject copy = jo;
+        CHECK( copy.get_int( "alpha" ) == 2 );
+        CHECK( copy.get_int( "mid" ) == 3 );
+        CHECK( copy.get_int( "zeta" ) == 1 );
+        jo.copy_visited_members( copy );
+        CHECK( capture_debugmsg_during( [&jo]() {
+            jo.finish();
+        } ).empty() );
+    }
+
+    SECTION( "duplicate members are rejected" ) {
+        const std::string duplicate = R"({ "b": 1, "a": 2, "b": 3 })";
+        JsonIn jsin( duplicate );
+        CHECK_THROWS_WITH( jsin.get_object(), Catch::Contains( "duplicate entry" ) );
+    }
+}
+
+TEST_CASE( "jsonobject_member_index_benchmark", "[.][json][benchmark]" )
+{
+    const std::string json = R"({
+        "id": "test_item", "type": "GENERIC", "category": "tools", "name": { "str": "test" },
+        "description": "A test item.", "weight": "500 g", "volume": "250 ml", "price": 1000,
+        "price_postapoc": 10, "to_hit": 1, "bashing": 5, "material": [ "steel", "plastic" ],
+        "symbol": ";", "color": "light_gray", "flags": [ "ALLOWS_REMOTE_USE" ],
+        "ammo": [ "battery" ], "charges_per_use": 1, "use_action": [ "foo" ],
+        "looks_like": "other_item", "qualities": [ [ "SCREW", 1 ] ]
+    })";
+    const std::vector<std::string> names = {
+        "id", "type", "category", "name", "description", "weight", "volume", "price",
+        "price_postapoc", "to_hit", "bashing", "material", "symbol", "color", "flags",
+        "ammo", "charges_per_use", "use_action", "looks_like", "qualities"
+    };
+    std::vector<std::string> missing_names;
+    for( const std::string &name : names ) {
+        missing_names.push_back( name + "_missing" );
+    }
+    BENCHMARK( "index and look up all members" ) {
+        JsonIn jsin( json );
+        JsonObject jo = jsin.get_object();
+        // Only looked up, not read, so finishing it must not report them
+        jo.allow_omitted_members();
+        int found = 0;
+        for( size_t i = 0; i < names.size(); ++i ) {
+            found += jo.has_member( names[i] );
+            found += jo.has_member( missing_names[i] );
+        }
+        return found;
+    };
+}
+
+template<typename T>
+static std::string stream_formatted( const T &val )
+{
+    std::ostringstream os;
+    os.imbue( std::locale::classic() );
+    os.setf( std::ios_base::showpoint );
+    os.setf( std::ios_base::fixed, std::ostream::floatfield );
+    os.setf( std::ios_base::boolalpha );
+    os << val;
+    return os.str();
+}
+
+template<typename T>
+static std::string json_formatted( const T &val )
+{
+    std::ostringstream os;
+    JsonOut jsout( os );
+    jsout.write( val );
+    return os.str();
+}
+
+TEST_CASE( "jsonout_formats_numbers_like_streams", "[json]" )
+{
+    for( const int val : {
+             0, 1, -1, 9, 10, -10, 123456, std::numeric_limits<int>::max(),
+             std::numeric_limits<int>::min()
+         } ) {
+        CHECK( json_formatted( val ) == stream_formatted( val ) );
+    }
+    CHECK( json_formatted( std::numeric_limits<int64_t>::min() ) ==
+           stream_formatted( std::numeric_limits<int64_t>::min() ) );
+    CHECK( json_formatted( std::numeric_limits<uint64_t>::max() ) ==
+           stream_formatted( std::numeric_limits<uint64_t>::max() ) );
+    CHECK( json_formatted( static_cast<short>( -300 ) ) == "-300" );
+    CHECK( json_formatted( true ) == "true" );
+    CHECK( json_formatted( false ) == "false" );
+    for( const double val : {
+             0.0, -0.0, 1.5, -2.25, 0.1, 1e-7, 3.14159265358979, 123456789.987654321, 1e300
+         } ) {
+        CHECK( json_formatted( val ) == stream_formatted( val ) );
+    }
+    CHECK( json_formatted( 0.3f ) == stream_formatted( 0.3f ) );
+}
+
+TEST_CASE( "jsonout_passes_complete_values_to_the_stream", "[json]" )
+{
+    std::ostringstream os;
+    JsonOut jsout( os );
+    jsout.start_object();
+    jsout.member( "id", "plain_id" );
+    jsout.member( "text", std::string( "a \"quote\", a \\ and\ttab\n\x01" ) );
+    // Nested values are passed on in blocks
+    jsout.flush();
+    CHECK( os.str() == R"({"id":"plain_id","text":"a \"quote\", a \\ and\ttab\n\u0001")" );
+    jsout.member( "list", std::vector<int> { 1, -2, 3 } );
+    jsout.end_object();
+    // and complete top level values right away
+    CHECK( os.str() ==
+           R"({"id":"plain_id","text":"a \"quote\", a \\ and\ttab\n\u0001","list":[1,-2,3]})" );
+    os << '\n';
+    jsout.write( 5 );
+    CHECK( os.str().substr( os.str().size() - 2 ) == "\n5" );
+}
+
+// Run with "[json][benchmark]" to time writing the save data of the submaps of the test map
+TEST_CASE( "jsonout_benchmark", "[.][json][benchmark]" )
+{
+    const auto write_map = []() {
+        std::ostringstream os;
+        JsonOut jsout( os );
+        jsout.start_array();
+        for( auto &sm : MAPBUFFER ) {
+            jsout.start_object();
+            sm.second->store( jsout );
+            jsout.end_object();
+        }
+        jsout.end_array();
+        return os.str().size();
+    };
+    const auto write_numbers = []() {
+        std::ostringstream os;
+        JsonOut jsout( os );
+        jsout.start_array();
+        for( int i = 0; i < 100000; ++i ) {
+            jsout.write( i * 7919 - 50000 );
+            jsout.write( i * 0.25 );
+            jsout.write( "t_floor" );
+        }
+        jsout.end_array();
+        return os.str().size();
+    };
+    BENCHMARK( "submaps" ) {
+        return write_map();
+    };
+    BENCHMARK( "numbers and ids" ) {
+        return write_numbers();
+    };
+}
+
 TEST_CASE( "item_colony_ser_deser", "[json][item]" )
 {
     // calculates the number of substring (needle) occurrences withing the target string (haystack)
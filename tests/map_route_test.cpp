@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <vector>
+
+#include "cata_catch.h"
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "optional.h"
+#include "pathfinding.h"
+#include "point.h"
+
+static pathfinding_settings walker_settings()
+{
+    // No bashing, generous distance limits, no climbing
+    return pathfinding_settings( 0, 60, 240, 0, false, false, true, false, false );
+}
+
+static void check_route_is_walkable( const std::vector<tripoint> &route, const tripoint &from,
+                                     const tripoint &to )
+{
+    const map &here = get_map();
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == to );
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        CHECK( square_dist( prev, p ) == 1 );
+        CHECK( here.passable( p ) );
+        prev = p;
+    }
+}
+
+TEST_CASE( "route_around_wall", "[map][pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+
+    const tripoint from( 40, 60, 0 );
+    const tripoint to( 80, 60, 0 );
+    // A wall between the endpoints with a single gap, forcing a detour
+    for( int y = 50; y <= 70; ++y ) {
+        if( y != 66 ) {
+            here.ter_set( tripoint( 60, y, 0 ), t_wall );
+        }
+    }
+
+    const std::vector<tripoint> route = here.route( from, to, walker_settings() );
+    check_route_is_walkable( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), tripoint( 60, 66, 0 ) ) != route.end() );
+
+    SECTION( "repeated searches reuse the search state without leaking it" ) {
+        // Seal the gap and the way around the wall, the route must now fail
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            here.ter_set( tripoint( 60, y, 0 ), t_wall );
+        }
+        CHECK( here.route( from, to, walker_settings() ).empty() );
+
+        // Reopen it, the same route must be found again
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            here.ter_set( tripoint( 60, y, 0 ), y >= 50 && y <= 70 && y != 66 ? t_wall : t_grass );
+        }
+        CHECK( here.route( from, to, walker_settings() ) == route );
+    }
+}
+
+TEST_CASE( "route_respects_pre_closed_points", "[map][pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+
+    const tripoint from( 50, 50, 0 );
+    const tripoint to( 56, 50, 0 );
+    const tripoint blocker( 53, 50, 0 );
+    // Surround the straight line so the fast line check is not taken
+    here.ter_set( tripoint( 53, 49, 0 ), t_wall );
+    here.ter_set( tripoint( 53, 51, 0 ), t_wall );
+
+    const std::vector<tripoint> route = here.route( from, to, walker_settings(), { blocker } );
+    check_route_is_walkable( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), blocker ) == route.end() );
+}
+
+TEST_CASE( "long_route_detours_beyond_padding", "[map][pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+
+    const tripoint from( 30, 60, 0 );
+    const tripoint to( 90, 60, 0 );
+    // The only way through is far outside of the padded search box around the endpoints
+    const tripoint gap( 60, 110, 0 );
+    for( int y = 0; y < MAPSIZE_Y; ++y ) {
+        if( y != gap.y ) {
+            here.ter_set( tripoint( 60, y, 0 ), t_wall );
+        }
+    }
+
+    // The detour costs about 260, more than walker_settings allows
+    pathfinding_settings settings = walker_settings();
+    settings.max_length = 1000;
+    const std::vector<tripoint> route = here.route( from, to, settings );
+    check_route_is_walkable( route, from, to );
+    CHECK( std::find( route.begin(), route.end(), gap ) != route.end() );
+
+    SECTION( "the whole route is limited by max_length" ) {
+        settings.max_length = 200;
+        CHECK( here.route( from, to, settings ).empty() );
+    }
+
+    SECTION( "a wall turning into a door opens the way" ) {
+        settings.allow_open_doors = true;
+        here.ter_set( gap, t_wall );
+        CHECK( here.route( from, to, settings ).empty() );
+
+        here.ter_set( gap, t_door_c );
+        const std::vector<tripoint> door_route = here.route( from, to, settings );
+        REQUIRE( !door_route.empty() );
+        CHECK( door_route.back() == to );
+        CHECK( std::find( door_route.begin(), door_route.end(), gap ) != door_route.end() );
+    }
+}
+
+// Follows the shared field from start, returns the tiles visited
+static std::vector<tripoint> follow_shared_field( const tripoint &start, const tripoint &goal,
+        const pathfinding_settings &settings )
+{
+    map &here = get_map();
+    // The field is only built once enough callers ask for the same goal
+    cata::optional<tripoint> step;
+    for( int i = 0; i < 10 && !step; ++i ) {
+        step = here.shared_route_step( start, goal, settings );
+    }
+    REQUIRE( step );
+
+    std::vector<tripoint> visited;
+    tripoint cur = start;
+    for( int i = 0; i < 200 && cur != goal; ++i ) {
+        const cata::optional<tripoint> next = here.shared_route_step( cur, goal, settings );
+        REQUIRE( next );
+        CHECK( square_dist( cur, *next ) == 1 );
+        CHECK( here.passable( *next ) );
+        visited.push_back( *next );
+        cur = *next;
+    }
+    CHECK( cur == goal );
+    return visited;
+}
+
+TEST_CASE( "shared_route_field", "[map][pathfinding]" )
+{
+    clear_map();
+    map &here = get_map();
+    const pathfinding_settings settings = walker_settings();
+
+    const tripoint start( 45, 60, 0 );
+    const tripoint goal( 60, 60, 0 );
+    const tripoint gap( 55, 54, 0 );
+    for( int y = 50; y <= 70; ++y ) {
+        if( y != gap.y ) {
+            here.ter_set( tripoint( 55, y, 0 ), t_wall );
+        }
+    }
+
+    std::vector<tripoint> visited = follow_shared_field( start, goal, settings );
+    CHECK( std::find( visited.begin(), visited.end(), gap ) != visited.end() );
+
+    // The field is dropped when the terrain changes, and rebuilt on demand
+    here.ter_set( gap, t_wall );
+    visited = follow_shared_field( start, goal, settings );
+    CHECK( std::find( visited.begin(), visited.end(), gap ) == visited.end() );
+}
@@ -2,15 +2,30 @@
 #include "map.h"
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "avatar.h"
+#include "cached_options.h"
+#include "cata_utility.h"
+#include "coordinate_conversions.h"
 #include "coordinates.h"
 #include "enums.h"
+#include "field_type.h"
+#include "filesystem.h"
 #include "game.h"
 #include "game_constants.h"
+#include "level_cache.h"
 #include "map_helpers.h"
+#include "mapbuffer.h"
+#include "mapdata.h"
+#include "options_helpers.h"
+#include "path_info.h"
 #include "point.h"
+#include "region_file.h"
+#include "string_formatter.h"
+#include "submap.h"
+#include "submap_binary.h"
 #include "type_id.h"
 
 TEST_CASE( "destroy_grabbed_furniture" )
@@ -93,3 +108,230 @@ TEST_CASE( "place_player_can_safely_move_multiple_submaps" )
     g->place_player( tripoint_zero );
     CHECK( get_map().check_submap_active_item_consistency().empty() );
 }
+
+// Snapshot of the caches build_map_cache rebuilds per z-level
+struct level_caches_snapshot {
+    std::vector<bool> outside;
+    std::vector<bool> floor;
+    std::vector<float> transparency;
+};
+
+static level_caches_snapshot rebuild_level_caches( map &m, const int threads )
+{
+    restore_on_out_of_scope<int> restore_threads( map_cache_threads );
+    map_cache_threads = threads;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        m.set_outside_cache_dirty( z );
+        m.set_floor_cache_dirty( z );
+        m.set_transparency_cache_dirty( z );
+    }
+    m.build_map_cache( 0, true );
+
+    level_caches_snapshot ret;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        const level_cache &ch = m.get_cache_ref( z );
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                ret.outside.push_back( ch.outside_cache[x][y] );
+                ret.floor.push_back( ch.floor_cache[x][y] );
+                ret.transparency.push_back( ch.transparency_cache[x][y] );
+            }
+        }
+    }
+    return ret;
+}
+
+TEST_CASE( "parallel_map_cache_matches_serial", "[map][lightmap]" )
+{
+    clear_map();
+    map &here = get_map();
+    // Roofed room, smoke and a hole in the floor, so every cache has something to build
+    for( int x = 20; x <= 30; ++x ) {
+        for( int y = 20; y <= 30; ++y ) {
+            const tripoint p( x, y, 0 );
+            const bool edge = x == 20 || x == 30 || y == 20 || y == 30;
+            here.ter_set( p, edge ? t_wall : t_floor );
+        }
+    }
+    for( const tripoint &p : here.points_in_radius( tripoint( 60, 60, 0 ), 3 ) ) {
+        here.add_field( p, fd_smoke, 3 );
+    }
+    here.ter_set( tripoint( 70, 70, 1 ), t_open_air );
+
+    const level_caches_snapshot serial = rebuild_level_caches( here, 1 );
+    const level_caches_snapshot parallel = rebuild_level_caches( here, 4 );
+    CHECK( serial.outside == parallel.outside );
+    CHECK( serial.floor == parallel.floor );
+    CHECK( serial.transparency == parallel.transparency );
+}
+
+TEST_CASE( "sees_cache_follows_transparency_changes", "[map][vision]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint from( 40, 40, 0 );
+    const tripoint to( 50, 40, 0 );
+    const tripoint between( 45, 40, 0 );
+    here.build_map_cache( 0, true );
+    REQUIRE( here.sees( from, to, -1 ) );
+    // Cached in both directions
+    CHECK( here.sees( to, from, -1 ) );
+
+    here.ter_set( between, t_wall );
+    here.build_map_cache( 0, true );
+    CHECK_FALSE( here.sees( from, to, -1 ) );
+    CHECK_FALSE( here.sees( to, from, -1 ) );
+
+    here.ter_set( between, t_floor );
+    here.build_map_cache( 0, true );
+    CHECK( here.sees( from, to, -1 ) );
+}
+
+static std::vector<std::string> saved_region_files()
+{
+    return get_files_from_path( ".region", PATH_INFO::world_base_save_path() + "/maps", true,
+                                true );
+}
+
+TEST_CASE( "mapbuffer_save_writes_changed_quads_in_background", "[map]" )
+{
+    clear_map();
+    override_option region_saves( "REGION_MAP_SAVES", "true" );
+    map &here = get_map();
+    const tripoint p( 65, 65, 0 );
+    here.save();
+    MAPBUFFER.save();
+    CHECK( MAPBUFFER.wait_for_pending_save() );
+    std::vector<std::string> files = saved_region_files();
+    REQUIRE( !files.empty() );
+
+    // Nothing changed, so nothing gets written again
+    for( const std::string &file : files ) {
+        REQUIRE( remove_file( file ) );
+    }
+    here.save();
+    MAPBUFFER.save();
+    CHECK( MAPBUFFER.wait_for_pending_save() );
+    CHECK( saved_region_files().empty() );
+
+    here.ter_set( p, t_wall );
+    here.save();
+    MAPBUFFER.save();
+    CHECK( MAPBUFFER.wait_for_pending_save() );
+    CHECK( saved_region_files().size() == 1 );
+}
+
+TEST_CASE( "mapbuffer_prefetch_reads_quads_in_advance", "[map]" )
+{
+    clear_map();
+    override_option region_saves( "REGION_MAP_SAVES", "true" );
+    map &here = get_map();
+    const tripoint far_sm = omt_to_sm_copy( sm_to_omt_copy( here.get_abs_sub() +
+                                            tripoint( 100, 0, 0 ) ) );
+    {
+        tinymap tm;
+        tm.load( tripoint_abs_sm( far_sm ), false );
+        tm.ter_set( tripoint( 1, 1, far_sm.z ), t_wall );
+    }
+    // Quads outside of the map are unloaded after saving them
+    MAPBUFFER.save();
+    MAPBUFFER.wait_for_pending_save();
+    const std::string region = region_file_path( PATH_INFO::world_base_save_path() + "/maps",
+                               sm_to_omt_copy( far_sm ) );
+    REQUIRE( file_exist( region ) );
+
+    MAPBUFFER.prefetch( { far_sm } );
+    // Keeps what the first call has read, as it is still wanted
+    MAPBUFFER.prefetch( { far_sm } );
+    REQUIRE( remove_file( region ) );
+    submap *sm = MAPBUFFER.lookup_submap( far_sm );
+    REQUIRE( sm != nullptr );
+    CHECK( sm->get_ter( point( 1, 1 ) ) == t_wall );
+}
+
+TEST_CASE( "mapbuffer_prefetch_forgets_missing_quads_once_saved", "[map]" )
+{
+    clear_map();
+    override_option region_saves( "REGION_MAP_SAVES", "true" );
+    map &here = get_map();
+    const tripoint far_sm = omt_to_sm_copy( sm_to_omt_copy( here.get_abs_sub() +
+                                            tripoint( 200, 0, 0 ) ) );
+    // Not saved yet, so the prefetch does not find it
+    MAPBUFFER.prefetch( { far_sm } );
+    MAPBUFFER.finish_prefetch();
+    {
+        tinymap tm;
+        tm.load( tripoint_abs_sm( far_sm ), false );
+        tm.ter_set( tripoint( 1, 1, far_sm.z ), t_wall );
+    }
+    // Quads outside of the map are unloaded after saving them
+    MAPBUFFER.save();
+    REQUIRE( MAPBUFFER.wait_for_pending_save() );
+    MAPBUFFER.prefetch( { far_sm } );
+    submap *sm = MAPBUFFER.lookup_submap( far_sm );
+    REQUIRE( sm != nullptr );
+    CHECK( sm->get_ter( point( 1, 1 ) ) == t_wall );
+}
+
+/** Saves the map and returns the saved quad that contains @p p. */
+static std::string save_quad_at( const tripoint &p )
+{
+    map &here = get_map();
+    // Uniform quads are not saved at all
+    here.ter_set( p, t_wall );
+    here.save();
+    MAPBUFFER.save();
+    REQUIRE( MAPBUFFER.wait_for_pending_save() );
+    const tripoint om_addr = ms_to_omt_copy( here.getabs( p ) );
+    const region_file region( region_file_path( PATH_INFO::world_base_save_path() + "/maps",
+                              om_addr ) );
+    std::string data;
+    REQUIRE( region.read( region_quad_position( om_addr ), data ) );
+    return data;
+}
+
+TEST_CASE( "map_saves_use_the_chosen_format", "[map]" )
+{
+    clear_map();
+    const tripoint p( 65, 65, 0 );
+    override_option no_compression( "COMPRESS_SAVES", "false" );
+    override_option region_saves( "REGION_MAP_SAVES", "true" );
+    SECTION( "json if disabled" ) {
+        override_option binary_saves( "BINARY_MAP_SAVES", "false" );
+        CHECK_FALSE( is_binary_submap_data( save_quad_at( p ) ) );
+    }
+    SECTION( "binary if enabled" ) {
+        override_option binary_saves( "BINARY_MAP_SAVES", "true" );
+        CHECK( is_binary_submap_data( save_quad_at( p ) ) );
+    }
+}
+
+TEST_CASE( "map_quads_move_into_region_files_once_enabled", "[map]" )
+{
+    clear_map();
+    map &here = get_map();
+    const tripoint p( 65, 65, 0 );
+    const tripoint om_addr = ms_to_omt_copy( here.getabs( p ) );
+    const tripoint segment = omt_to_seg_copy( om_addr );
+    const std::string maps_dir = PATH_INFO::world_base_save_path() + "/maps";
+    const std::string quad_path = string_format( "%s/%d.%d.%d/%d.%d.%d.map", maps_dir, segment.x,
+                                  segment.y, segment.z, om_addr.x, om_addr.y, om_addr.z );
+    {
+        override_option region_saves( "REGION_MAP_SAVES", "false" );
+        here.ter_set( p, t_wall );
+        here.save();
+        MAPBUFFER.save();
+        REQUIRE( MAPBUFFER.wait_for_pending_save() );
+        CHECK( file_exist( quad_path ) );
+    }
+
+    override_option region_saves( "REGION_MAP_SAVES", "true" );
+    here.ter_set( p, t_floor );
+    here.save();
+    MAPBUFFER.save();
+    REQUIRE( MAPBUFFER.wait_for_pending_save() );
+    CHECK_FALSE( file_exist( quad_path ) );
+    const region_file region( region_file_path( maps_dir, om_addr ) );
+    std::string data;
+    CHECK( region.read( region_quad_position( om_addr ), data ) );
+}
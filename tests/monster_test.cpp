@@ -12,6 +12,7 @@
 #include "cata_utility.h"
 #include "cata_catch.h"
 #include "character.h"
+#include "creature_tracker.h"
 #include "game.h"
 #include "game_constants.h"
 #include "line.h"
@@ -25,7 +26,9 @@
 #include "options_helpers.h"
 #include "point.h"
 #include "test_statistics.h"
+#include "sounds.h"
 #include "type_id.h"
+#include "weather_type.h"
 
 class item;
 
@@ -378,3 +381,80 @@ TEST_CASE( "monster_broken_verify", "[monster]" )
         CHECK( targetitemid.is_valid() );
     }
 }
+
+// Brute force version of Creature_tracker::find_in_radius
+static std::vector<monster *> monsters_in_radius( const tripoint &center, const int radius )
+{
+    std::vector<monster *> result;
+    for( monster &critter : g->all_monsters() ) {
+        if( rl_dist( center, critter.pos() ) <= radius ) {
+            result.push_back( &critter );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static void check_area_queries()
+{
+    for( const tripoint &center : {
+             tripoint( 0, 0, 0 ), tripoint( 60, 60, 0 ), tripoint( 67, 59, 0 ), tripoint( 131, 131, 0 )
+         } ) {
+        for( const int radius : { 0, 1, 5, 8, 20, 200 } ) {
+            CAPTURE( center, radius );
+            std::vector<monster *> found = g->critter_tracker->find_in_radius( center, radius );
+            std::sort( found.begin(), found.end() );
+            CHECK( found == monsters_in_radius( center, radius ) );
+        }
+    }
+}
+
+TEST_CASE( "creature_tracker_area_queries", "[monster]" )
+{
+    clear_creatures();
+    std::vector<monster *> spawned;
+    for( int x = 55; x < 75; x += 3 ) {
+        for( int y = 50; y < 70; y += 4 ) {
+            spawned.push_back( &spawn_test_monster( "mon_zombie", tripoint( x, y, 0 ) ) );
+        }
+    }
+    spawned.push_back( &spawn_test_monster( "mon_zombie", tripoint( 0, 0, 0 ) ) );
+    check_area_queries();
+
+    SECTION( "moving monsters" ) {
+        spawned[0]->setpos( tripoint( 130, 131, 0 ) );
+        spawned[1]->setpos( tripoint( 66, 60, 0 ) );
+        check_area_queries();
+    }
+    SECTION( "swapping monsters" ) {
+        g->swap_critters( *spawned[0], *spawned.back() );
+        check_area_queries();
+    }
+    SECTION( "removing monsters" ) {
+        spawned[2]->die( nullptr );
+        g->remove_zombie( *spawned[3] );
+        check_area_queries();
+        g->cleanup_dead();
+        check_area_queries();
+    }
+}
+
+TEST_CASE( "monsters_hear_sounds_in_range", "[monster][sounds]" )
+{
+    clear_creatures();
+    clear_map();
+    scoped_weather_override weather_clear( WEATHER_CLEAR );
+    const tripoint source( 60, 60, 0 );
+    monster &near = spawn_test_monster( "mon_zombie", source + tripoint( 10, -7, 0 ) );
+    monster &edge = spawn_test_monster( "mon_zombie", source + tripoint( -39, 0, 0 ) );
+    monster &far = spawn_test_monster( "mon_zombie", source + tripoint( 0, 45, 0 ) );
+    REQUIRE( near.wandf == 0 );
+    REQUIRE( edge.wandf == 0 );
+    REQUIRE( far.wandf == 0 );
+
+    sounds::sound( source, 40, sounds::sound_t::combat, "BOOM" );
+    sounds::process_sounds();
+    CHECK( near.wandf > 0 );
+    CHECK( edge.wandf > 0 );
+    CHECK( far.wandf == 0 );
+}
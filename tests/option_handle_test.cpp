@@ -0,0 +1,68 @@
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cata_catch.h"
+#include "options.h"
+#include "options_helpers.h"
+#include "turn_profiler.h"
+
+TEST_CASE( "option_handle_follows_changes_of_the_option", "[options]" )
+{
+    const option_handle<int> autosave_turns( "AUTOSAVE_TURNS" );
+    const option_handle<std::string> distance_units( "DISTANCE_UNITS" );
+    CHECK( autosave_turns.value() == get_option<int>( "AUTOSAVE_TURNS" ) );
+
+    {
+        override_option turns( "AUTOSAVE_TURNS", "123" );
+        override_option units( "DISTANCE_UNITS", "imperial" );
+        CHECK( autosave_turns.value() == 123 );
+        CHECK( distance_units.value() == "imperial" );
+
+        override_option other_units( "DISTANCE_UNITS", "metric" );
+        CHECK( distance_units.value() == "metric" );
+    }
+    CHECK( autosave_turns.value() == get_option<int>( "AUTOSAVE_TURNS" ) );
+    CHECK( distance_units.value() == get_option<std::string>( "DISTANCE_UNITS" ) );
+}
+
+TEST_CASE( "option_handle_does_not_look_up_the_option_again", "[options]" )
+{
+    const option_handle<bool> autosave( "AUTOSAVE" );
+    const bool expected = get_option<bool>( "AUTOSAVE" );
+    CHECK( autosave.value() == expected );
+
+    turn_profiler::reset();
+    turn_profiler::set_enabled( true );
+    for( int i = 0; i < 10; ++i ) {
+        CHECK( autosave.value() == expected );
+    }
+    CHECK( turn_profiler::option_lookups() == 0 );
+    get_option<bool>( "AUTOSAVE" );
+    CHECK( turn_profiler::option_lookups() == 1 );
+    turn_profiler::set_enabled( false );
+    turn_profiler::reset();
+}
+
+TEST_CASE( "option_handle_can_be_read_from_several_threads", "[options]" )
+{
+    const option_handle<std::string> distance_units( "DISTANCE_UNITS" );
+    override_option units( "DISTANCE_UNITS", "imperial" );
+
+    std::atomic<int> mismatches( 0 );
+    std::vector<std::thread> threads;
+    for( int i = 0; i < 4; ++i ) {
+        threads.emplace_back( [&distance_units, &mismatches]() {
+            for( int j = 0; j < 1000; ++j ) {
+                if( distance_units.value() != "imperial" ) {
+                    ++mismatches;
+                }
+            }
+        } );
+    }
+    for( std::thread &thread : threads ) {
+        thread.join();
+    }
+    CHECK( mismatches == 0 );
+}
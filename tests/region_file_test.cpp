@@ -0,0 +1,125 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cata_catch.h"
+#include "cata_utility.h"
+#include "filesystem.h"
+#include "game_constants.h"
+#include "path_info.h"
+#include "point.h"
+#include "region_file.h"
+
+static std::string region_test_dir()
+{
+    const std::string dir = PATH_INFO::savedir() + "region_file_test";
+    for( const std::string &file : get_files_from_path( "", dir, true ) ) {
+        remove_file( file );
+    }
+    REQUIRE( assure_dir_exist( dir ) );
+    return dir;
+}
+
+static std::string read_quad( const region_file &file, const point &quad )
+{
+    std::string data;
+    REQUIRE( file.read( quad, data ) );
+    return data;
+}
+
+TEST_CASE( "region_file_stores_quads", "[map][region_file]" )
+{
+    const std::string path = region_test_dir() + "/0.0.0.region";
+    region_file file( path );
+    std::string data;
+    CHECK_FALSE( file.read( point_zero, data ) );
+
+    const std::string big( 10000, 'x' );
+    file.write( { { point_zero, "first" }, { point( 31, 31 ), big }, { point( 5, 2 ), "" } } );
+    CHECK( read_quad( file, point_zero ) == "first" );
+    CHECK( read_quad( file, point( 31, 31 ) ) == big );
+    CHECK( read_quad( file, point( 5, 2 ) ).empty() );
+    CHECK_FALSE( file.read( point( 1, 0 ), data ) );
+    CHECK( file.quads().size() == 3 );
+
+    SECTION( "replaced quads reuse the space of older versions" ) {
+        file.write( { { point_zero, "second" } } );
+        const size_t size = read_entire_file( path ).size();
+        for( int i = 0; i < 10; ++i ) {
+            file.write( { { point_zero, std::to_string( i ) } } );
+        }
+        CHECK( read_quad( file, point_zero ) == "9" );
+        CHECK( read_entire_file( path ).size() == size );
+        CHECK( read_quad( file, point( 31, 31 ) ) == big );
+    }
+
+    SECTION( "an interrupted write leaves the previous version" ) {
+        file.write( { { point_zero, "second" } } );
+        REQUIRE( read_quad( file, point_zero ) == "second" );
+        // That write replaced the first of the two tables, which follows the magic bytes.
+        // Damage it as if writing it was interrupted.
+        std::string contents = read_entire_file( path );
+        contents[8 + 8 + 4] ^= 0x7F;
+        write_to_file( path, [&]( std::ostream & fout ) {
+            fout << contents;
+        } );
+        // The file was changed behind the back of the first object
+        const region_file reopened( path );
+        CHECK( read_quad( reopened, point_zero ) == "first" );
+        CHECK( read_quad( reopened, point( 31, 31 ) ) == big );
+        // The next write goes on from the previous version
+        file.write( { { point( 1, 0 ), "third" } } );
+        CHECK( read_quad( file, point_zero ) == "first" );
+        CHECK( read_quad( file, point( 1, 0 ) ) == "third" );
+    }
+
+    SECTION( "reads keep up with writes through the same object" ) {
+        REQUIRE( read_quad( file, point_zero ) == "first" );
+        file.write( { { point_zero, "second" }, { point( 2, 2 ), "new" } } );
+        CHECK( read_quad( file, point_zero ) == "second" );
+        CHECK( read_quad( file, point( 2, 2 ) ) == "new" );
+        CHECK( file.quads().size() == 4 );
+        // Another object reading the file agrees
+        CHECK( read_quad( region_file( path ), point_zero ) == "second" );
+    }
+
+    SECTION( "malformed files are rejected" ) {
+        write_to_file( path, []( std::ostream & fout ) {
+            fout << "[ \"not a region\" ]";
+        } );
+        const region_file malformed( path );
+        CHECK_THROWS( malformed.read( point_zero, data ) );
+        CHECK_THROWS( malformed.read( point( SEG_SIZE, 0 ), data ) );
+    }
+}
+
+TEST_CASE( "region_file_paths", "[map][region_file]" )
+{
+    CHECK( region_file_path( "maps", tripoint( 0, 0, 0 ) ) == "maps/0.0.0.region" );
+    CHECK( region_file_path( "maps", tripoint( 33, -1, 2 ) ) == "maps/1.-1.2.region" );
+    CHECK( region_quad_position( tripoint( 33, -1, 2 ) ) == point( 1, 31 ) );
+}
+
+TEST_CASE( "migrate_quad_files_to_regions", "[map][region_file]" )
+{
+    const std::string maps_dir = region_test_dir();
+    REQUIRE( assure_dir_exist( maps_dir + "/1.0.0" ) );
+    REQUIRE( assure_dir_exist( maps_dir + "/0.0.-1" ) );
+    const auto write_quad = []( const std::string & path, const std::string & contents ) {
+        write_to_file( path, [&]( std::ostream & fout ) {
+            fout << contents;
+        } );
+    };
+    write_quad( maps_dir + "/1.0.0/32.1.0.map", "a" );
+    write_quad( maps_dir + "/1.0.0/40.3.0.map", "b" );
+    write_quad( maps_dir + "/0.0.-1/3.4.-1.map", "c" );
+    // Files of single quads are only written without region files, after the region was
+    region_file( maps_dir + "/1.0.0.region" ).write( { { point( 8, 3 ), "older" } } );
+
+    CHECK( migrate_quad_files_to_regions( maps_dir ) == 3 );
+    CHECK( get_files_from_path( ".map", maps_dir, true, true ).empty() );
+    CHECK_FALSE( dir_exist( maps_dir + "/1.0.0" ) );
+    CHECK( read_quad( region_file( maps_dir + "/1.0.0.region" ), point( 0, 1 ) ) == "a" );
+    CHECK( read_quad( region_file( maps_dir + "/1.0.0.region" ), point( 8, 3 ) ) == "b" );
+    CHECK( read_quad( region_file( maps_dir + "/0.0.-1.region" ), point( 3, 4 ) ) == "c" );
+}
@@ -0,0 +1,269 @@
+#include <array>
+
+#include "cata_catch.h"
+#include "game_constants.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "point.h"
+#include "scent_map.h"
+#include "type_id.h"
+
+static constexpr int scent_radius = 40;
+
+static const tripoint scent_center( 60, 60, 0 );
+
+static int scent_at( const point &offset )
+{
+    return get_scent().get( scent_center + offset );
+}
+
+static int total_scent_near_center( int range )
+{
+    int total = 0;
+    for( int x = -range; x <= range; ++x ) {
+        for( int y = -range; y <= range; ++y ) {
+            total += scent_at( point( x, y ) );
+        }
+    }
+    return total;
+}
+
+using scent_grid = std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X>;
+
+// The diffusion of scent_map::update over the whole scent radius, as it was before it
+// learned to skip the squares without scent nearby.
+static void diffuse_everywhere( scent_grid &grscent, const tripoint &center, map &m )
+{
+    scent_grid sum_3_scent_y;
+    scent_grid squares_used_y;
+    std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> blocks_scent;
+    std::array<std::array<bool, MAPSIZE_X>, MAPSIZE_Y> reduces_scent;
+    const int minx = center.x - scent_radius;
+    const int maxx = center.x + scent_radius;
+    const int miny = center.y - scent_radius;
+    const int maxy = center.y + scent_radius;
+    const int diffusivity = 100;
+
+    m.scent_blockers( blocks_scent, reduces_scent, point( minx - 1, miny - 1 ),
+                      point( maxx + 1, maxy + 1 ) );
+    for( int x = minx - 1; x <= maxx + 1; ++x ) {
+        for( int y = miny; y <= maxy; ++y ) {
+            sum_3_scent_y[y][x] = 0;
+            squares_used_y[y][x] = 0;
+            for( int i = y - 1; i <= y + 1; ++i ) {
+                if( !blocks_scent[x][i] ) {
+                    const int weight = reduces_scent[x][i] ? 2 : 10;
+                    sum_3_scent_y[y][x] += weight * grscent[x][i];
+                    squares_used_y[y][x] += weight;
+                }
+            }
+        }
+    }
+    for( int x = minx; x <= maxx; ++x ) {
+        for( int y = miny; y <= maxy; ++y ) {
+            int &scent_here = grscent[x][y];
+            if( blocks_scent[x][y] ) {
+                scent_here = 0;
+                continue;
+            }
+            const int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] +
+                                     squares_used_y[y][x + 1];
+            const int this_diffusivity = reduces_scent[x][y] ? diffusivity / 5 : diffusivity;
+            int temp_scent = scent_here * ( 10 * 1000 - squares_used * this_diffusivity );
+            temp_scent -= scent_here * this_diffusivity * ( 90 - squares_used ) / 5;
+            scent_here = ( temp_scent + this_diffusivity * ( sum_3_scent_y[y][x - 1] +
+                           sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1] ) ) / ( 1000 * 10 );
+        }
+    }
+}
+
+static void check_scent_matches( const scent_grid &expected )
+{
+    scent_map &scent = get_scent();
+    int mismatches = 0;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            if( scent.get( tripoint( x, y, 0 ) ) != expected[x][y] ) {
+                CAPTURE( x, y, expected[x][y], scent.get( tripoint( x, y, 0 ) ) );
+                mismatches++;
+            }
+        }
+    }
+    CHECK( mismatches == 0 );
+}
+
+TEST_CASE( "scent_diffusion_matches_diffusion_over_the_whole_radius", "[scent]" )
+{
+    clear_map();
+    map &here = get_map();
+    scent_map &scent = get_scent();
+    scent.reset();
+
+    // A wall and a row of trees to block and reduce the scent
+    for( int i = 0; i < 20; ++i ) {
+        here.ter_set( scent_center + point( 5, i - 10 ), ter_id( "t_wall" ) );
+        here.ter_set( scent_center + point( i - 10, -5 ), ter_id( "t_tree" ) );
+    }
+
+    scent_grid expected = {};
+    const auto set_scent = [&]( const point & p, int value ) {
+        scent.set( tripoint( p, 0 ), value );
+        expected[p.x][p.y] = value;
+    };
+
+    SECTION( "without scent" ) {
+    }
+    SECTION( "a trail of scent" ) {
+        for( int i = 0; i < 30; ++i ) {
+            set_scent( scent_center.xy() + point( i - 15, i / 2 - 5 ), 500 + i * 10 );
+        }
+    }
+    SECTION( "scent at the edges of the scent radius" ) {
+        set_scent( scent_center.xy() + point( -scent_radius - 1, 3 ), 400 );
+        set_scent( scent_center.xy() + point( scent_radius + 1, scent_radius + 1 ), 400 );
+        set_scent( scent_center.xy() + point( 7, -scent_radius ), 300 );
+        set_scent( scent_center.xy() + point( scent_radius, -scent_radius - 1 ), 300 );
+    }
+    SECTION( "scent in the border rows and columns around the scent radius" ) {
+        for( int i = -scent_radius - 1; i <= scent_radius + 1; ++i ) {
+            set_scent( scent_center.xy() + point( i, -scent_radius - 1 ), 200 + i );
+            set_scent( scent_center.xy() + point( scent_radius + 1, i ), 300 + i );
+        }
+    }
+    SECTION( "scent in the corners of the scent radius" ) {
+        set_scent( scent_center.xy() + point( -scent_radius, -scent_radius ), 500 );
+        set_scent( scent_center.xy() + point( scent_radius, scent_radius ), 500 );
+        set_scent( scent_center.xy() + point( -scent_radius - 1, scent_radius + 1 ), 500 );
+    }
+    SECTION( "scent everywhere" ) {
+        const int border = scent_radius + 1;
+        for( int x = scent_center.x - border; x <= scent_center.x + border; ++x ) {
+            for( int y = scent_center.y - border; y <= scent_center.y + border; ++y ) {
+                set_scent( point( x, y ), ( x * 7 + y * 13 ) % 300 );
+            }
+        }
+    }
+
+    for( int turn = 0; turn < 20; ++turn ) {
+        CAPTURE( turn );
+        scent.update( scent_center, here );
+        diffuse_everywhere( expected, scent_center, here );
+        check_scent_matches( expected );
+    }
+    scent.reset();
+}
+
+TEST_CASE( "scent_spreads_to_neighboring_squares", "[scent]" )
+{
+    clear_map();
+    map &here = get_map();
+    scent_map &scent = get_scent();
+    scent.reset();
+
+    SECTION( "without scent nothing changes" ) {
+        scent.update( scent_center, here );
+        CHECK( total_scent_near_center( scent_radius + 1 ) == 0 );
+    }
+
+    SECTION( "a single source spreads evenly to its neighbors" ) {
+        scent.set( scent_center, 1000 );
+        scent.update( scent_center, here );
+
+        const int source = scent_at( point_zero );
+        CHECK( source > 0 );
+        CHECK( source < 1000 );
+        for( const tripoint &neighbor : eight_horizontal_neighbors ) {
+            const point d = neighbor.xy();
+            CAPTURE( d );
+            CHECK( scent_at( d ) > 0 );
+            CHECK( scent_at( d ) < source );
+            CHECK( scent_at( d ) == scent_at( point_east ) );
+            // Scent moves one square per update
+            CHECK( scent_at( 2 * d ) == 0 );
+        }
+        // Open ground neither creates nor absorbs scent
+        CHECK( total_scent_near_center( 2 ) == 1000 );
+    }
+
+    SECTION( "scent keeps spreading symmetrically" ) {
+        scent.set( scent_center, 1000 );
+        for( int turn = 0; turn < 10; ++turn ) {
+            scent.update( scent_center, here );
+        }
+        for( int x = 0; x <= 11; ++x ) {
+            for( int y = 0; y <= 11; ++y ) {
+                CAPTURE( x, y );
+                CHECK( scent_at( point( x, y ) ) == scent_at( point( -x, y ) ) );
+                CHECK( scent_at( point( x, y ) ) == scent_at( point( x, -y ) ) );
+                CHECK( scent_at( point( x, y ) ) == scent_at( point( y, x ) ) );
+            }
+        }
+        CHECK( scent_at( point( 3, 0 ) ) > 0 );
+        CHECK( scent_at( point( 3, 0 ) ) < scent_at( point( 2, 0 ) ) );
+        CHECK( scent_at( point( 11, 0 ) ) == 0 );
+    }
+    scent.reset();
+}
+
+TEST_CASE( "scent_is_blocked_by_walls_and_reduced_by_trees", "[scent]" )
+{
+    clear_map();
+    map &here = get_map();
+    scent_map &scent = get_scent();
+    scent.reset();
+
+    SECTION( "walls lose their scent and keep it from passing" ) {
+        // Long enough that the scent cannot go around it in the updates below
+        for( int y = -15; y <= 15; ++y ) {
+            here.ter_set( scent_center + point( 3, y ), ter_id( "t_wall" ) );
+        }
+        scent.set( scent_center, 1000 );
+        scent.set( scent_center + point( 3, 0 ), 1000 );
+        for( int turn = 0; turn < 10; ++turn ) {
+            scent.update( scent_center, here );
+        }
+        CHECK( scent_at( point( 3, 0 ) ) == 0 );
+        CHECK( scent_at( point( -4, 0 ) ) > 0 );
+        for( int y = -10; y <= 10; ++y ) {
+            CAPTURE( y );
+            CHECK( scent_at( point( 4, y ) ) == 0 );
+        }
+    }
+
+    SECTION( "less scent spreads onto trees than onto open ground" ) {
+        here.ter_set( scent_center + point_east, ter_id( "t_tree" ) );
+        scent.set( scent_center, 1000 );
+        scent.update( scent_center, here );
+        CHECK( scent_at( point_east ) > 0 );
+        CHECK( scent_at( point_east ) < scent_at( point_west ) );
+        CHECK( total_scent_near_center( 2 ) < 1000 );
+    }
+    scent.reset();
+}
+
+TEST_CASE( "scent_only_changes_within_the_scent_radius", "[scent]" )
+{
+    clear_map();
+    map &here = get_map();
+    scent_map &scent = get_scent();
+    scent.reset();
+
+    SECTION( "scent on the edge of the radius spreads inwards only" ) {
+        scent.set( scent_center + point( scent_radius, 0 ), 1000 );
+        scent.update( scent_center, here );
+        CHECK( scent_at( point( scent_radius, 0 ) ) < 1000 );
+        CHECK( scent_at( point( scent_radius - 1, 0 ) ) > 0 );
+        CHECK( scent_at( point( scent_radius + 1, 0 ) ) == 0 );
+    }
+
+    SECTION( "scent beyond the radius stays but still spreads inwards" ) {
+        scent.set( scent_center + point( scent_radius + 1, 0 ), 1000 );
+        scent.set( scent_center + point( 0, -scent_radius - 5 ), 500 );
+        scent.update( scent_center, here );
+        CHECK( scent_at( point( scent_radius + 1, 0 ) ) == 1000 );
+        CHECK( scent_at( point( scent_radius, 0 ) ) > 0 );
+        CHECK( scent_at( point( 0, -scent_radius - 5 ) ) == 500 );
+        CHECK( scent_at( point( 0, -scent_radius - 4 ) ) == 0 );
+    }
+    scent.reset();
+}
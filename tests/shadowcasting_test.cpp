@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <functional>
 #include <sstream>
@@ -8,6 +9,7 @@
 #include <vector>
 
 #include "cata_catch.h"
+#include "cata_utility.h"
 #include "cuboid_rectangle.h"
 #include "game_constants.h"
 #include "level_cache.h"
@@ -1065,6 +1067,183 @@ TEST_CASE( "shadowcasting_floating_wall", "[shadowcasting]" )
     run_spot_check( test_case, expected_results, true );
 }
 
+// The tile-by-tile castLight, kept to check that handling runs of equal tiles a row at a time
+// gives exactly the same output.
+// NOLINTNEXTLINE(cata-xy)
+template<int xx, int xy, int yx, int yy, typename Out,
+         void( *update_output )( Out &, const float &, quadrant )>
+static void per_tile_cast_light( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
+                                 const float ( &input_array )[MAPSIZE_X][MAPSIZE_Y],
+                                 const point &offset, const int row = 1, float start = 1.0f,
+                                 const float end = 0.0f,
+                                 float cumulative_transparency = LIGHT_TRANSPARENCY_OPEN_AIR )
+{
+    const quadrant quad = ( -xx - xy > 0 ) ?
+                          ( ( -yx - yy > 0 ) ? quadrant::NW : quadrant::SW ) :
+                          ( ( -yx - yy > 0 ) ? quadrant::NE : quadrant::SE );
+    float newStart = 0.0f;
+    const float radius = 60.0f;
+    if( start < end ) {
+        return;
+    }
+    float last_intensity = 0.0f;
+    tripoint delta;
+    for( int distance = row; distance <= radius; distance++ ) {
+        delta.y = -distance;
+        bool started_row = false;
+        float current_transparency = 0.0f;
+        const float away = start - ( -distance + 0.5f ) / ( -distance - 0.5f );
+        delta.x = -distance + std::max( static_cast<int>( std::ceil( away * ( -distance - 0.5f ) ) ),
+                                        0 );
+        for( ; delta.x <= 0; delta.x++ ) {
+            const point current( offset.x + delta.x * xx + delta.y * xy,
+                                 offset.y + delta.x * yx + delta.y * yy );
+            const float trailingEdge = ( delta.x - 0.5f ) / ( delta.y + 0.5f );
+            const float leadingEdge = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
+            if( !( current.x >= 0 && current.y >= 0 && current.x < MAPSIZE_X &&
+                   current.y < MAPSIZE_Y ) ) {
+                continue;
+            } else if( end > trailingEdge ) {
+                break;
+            }
+            if( !started_row ) {
+                started_row = true;
+                current_transparency = input_array[current.x][current.y];
+            }
+            last_intensity = sight_calc( VISIBILITY_FULL, cumulative_transparency,
+                                         rl_dist( tripoint_zero, delta ) );
+            const float new_transparency = input_array[current.x][current.y];
+            update_output( output_cache[current.x][current.y], last_intensity,
+                           sight_check( new_transparency, last_intensity ) ? quadrant::default_ : quad );
+            if( new_transparency == current_transparency ) {
+                newStart = leadingEdge;
+                continue;
+            }
+            if( sight_check( current_transparency, last_intensity ) ) {
+                per_tile_cast_light<xx, xy, yx, yy, Out, update_output>(
+                    output_cache, input_array, offset, distance + 1, start, trailingEdge,
+                    accumulate_transparency( cumulative_transparency, current_transparency, distance ) );
+            }
+            if( !sight_check( current_transparency, last_intensity ) ) {
+                start = newStart;
+            } else {
+                start = trailingEdge;
+            }
+            if( start < end ) {
+                return;
+            }
+            current_transparency = new_transparency;
+            newStart = leadingEdge;
+        }
+        if( !sight_check( current_transparency, last_intensity ) ) {
+            break;
+        }
+        cumulative_transparency = accumulate_transparency( cumulative_transparency,
+                                  current_transparency, distance );
+    }
+}
+
+template<typename Out, void( *update_output )( Out &, const float &, quadrant )>
+static void per_tile_cast_light_all( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
+                                     const float ( &input_array )[MAPSIZE_X][MAPSIZE_Y],
+                                     const point &offset )
+{
+    per_tile_cast_light<0, 1, 1, 0, Out, update_output>( output_cache, input_array, offset );
+    per_tile_cast_light<1, 0, 0, 1, Out, update_output>( output_cache, input_array, offset );
+    per_tile_cast_light < 0, -1, 1, 0, Out, update_output > ( output_cache, input_array, offset );
+    per_tile_cast_light < -1, 0, 0, 1, Out, update_output > ( output_cache, input_array, offset );
+    per_tile_cast_light < 0, 1, -1, 0, Out, update_output > ( output_cache, input_array, offset );
+    per_tile_cast_light < 1, 0, 0, -1, Out, update_output > ( output_cache, input_array, offset );
+    per_tile_cast_light < 0, -1, -1, 0, Out, update_output > ( output_cache, input_array, offset );
+    per_tile_cast_light < -1, 0, 0, -1, Out, update_output > ( output_cache, input_array, offset );
+}
+
+// Fills the cache with runs of open air, smoke-like translucent tiles and walls
+static void fill_transparency_runs( float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    const std::array<float, 3> values = {{
+            LIGHT_TRANSPARENCY_OPEN_AIR, LIGHT_TRANSPARENCY_OPEN_AIR * 5, LIGHT_TRANSPARENCY_SOLID
+        }
+    };
+    float value = values[0];
+    for( auto &inner : transparency_cache ) {
+        for( float &square : inner ) {
+            if( one_in( 6 ) ) {
+                value = values[rng( 0, 2 )];
+            }
+            square = value;
+        }
+    }
+}
+
+TEST_CASE( "shadowcasting_row_kernels_match_scalar", "[shadowcasting]" )
+{
+    std::vector<float> row( 256 );
+    for( int iteration = 0; iteration < 200; ++iteration ) {
+        const float value = LIGHT_TRANSPARENCY_OPEN_AIR;
+        for( float &v : row ) {
+            v = one_in( 20 ) ? LIGHT_TRANSPARENCY_SOLID : value;
+        }
+        const int count = rng( 0, 100 );
+        for( const int stride : {
+                 1, -1, 2
+             } ) {
+            CAPTURE( count, stride );
+            float *first = stride < 0 ? &row[200] : &row[0];
+            CHECK( transparency_run_length( first, stride, count, value ) ==
+                   transparency_run_length_scalar( first, stride, count, value ) );
+
+            std::vector<float> vectorized = row;
+            std::vector<float> scalar = row;
+            const float raised = rng_float( 0.0, 0.1 );
+            const int offset = stride < 0 ? 200 : 0;
+            raise_to_at_least( &vectorized[offset], stride, count, raised );
+            raise_to_at_least_scalar( &scalar[offset], stride, count, raised );
+            CHECK( vectorized == scalar );
+        }
+    }
+}
+
+TEST_CASE( "shadowcasting_row_batching_equivalence", "[shadowcasting]" )
+{
+    static float transparency_cache[MAPSIZE_X][MAPSIZE_Y];
+    static float seen_batched[MAPSIZE_X][MAPSIZE_Y];
+    static float seen_per_tile[MAPSIZE_X][MAPSIZE_Y];
+    static four_quadrants lit_batched[MAPSIZE_X][MAPSIZE_Y];
+    static four_quadrants lit_per_tile[MAPSIZE_X][MAPSIZE_Y];
+
+    restore_on_out_of_scope<bool> restore_trigdist( trigdist );
+    trigdist = GENERATE( false, true );
+    for( int iteration = 0; iteration < 10; ++iteration ) {
+        fill_transparency_runs( transparency_cache );
+        const point offset( rng( 0, MAPSIZE_X - 1 ), rng( 0, MAPSIZE_Y - 1 ) );
+        std::fill_n( &seen_batched[0][0], MAPSIZE_X * MAPSIZE_Y, 0.0f );
+        std::fill_n( &seen_per_tile[0][0], MAPSIZE_X * MAPSIZE_Y, 0.0f );
+        std::fill_n( &lit_batched[0][0], MAPSIZE_X * MAPSIZE_Y, four_quadrants( 0.0f ) );
+        std::fill_n( &lit_per_tile[0][0], MAPSIZE_X * MAPSIZE_Y, four_quadrants( 0.0f ) );
+
+        castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+            seen_batched, transparency_cache, offset );
+        per_tile_cast_light_all<float, update_light>( seen_per_tile, transparency_cache, offset );
+        castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                     accumulate_transparency>( lit_batched, transparency_cache, offset );
+        per_tile_cast_light_all<four_quadrants, update_light_quadrants>( lit_per_tile,
+                transparency_cache, offset );
+
+        int seen_mismatches = 0;
+        int lit_mismatches = 0;
+        for( int x = 0; x < MAPSIZE_X; ++x ) {
+            for( int y = 0; y < MAPSIZE_Y; ++y ) {
+                seen_mismatches += seen_batched[x][y] != seen_per_tile[x][y];
+                lit_mismatches += lit_batched[x][y].values != lit_per_tile[x][y].values;
+            }
+        }
+        CAPTURE( trigdist, offset );
+        CHECK( seen_mismatches == 0 );
+        CHECK( lit_mismatches == 0 );
+    }
+}
+
 // Some random edge cases aren't matching.
 TEST_CASE( "shadowcasting_runoff", "[.]" )
 {
@@ -4,6 +4,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "calendar.h"
@@ -20,6 +21,7 @@
 #include "point.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "submap_binary.h"
 #include "trap.h"
 #include "type_id.h"
 #include "vehicle.h"
@@ -1354,3 +1356,52 @@ TEST_CASE( "submap_computer_load", "[submap][load]" )
     REQUIRE( sm.has_computer( point_south ) );
     REQUIRE( sm.has_computer( {3, 5} ) );
 }
+
+static std::string submap_as_json( const submap &sm )
+{
+    std::ostringstream os;
+    JsonOut jsout( os );
+    jsout.start_object();
+    sm.store( jsout );
+    jsout.end_object();
+    return os.str();
+}
+
+TEST_CASE( "submap_binary_round_trip", "[submap][load]" )
+{
+    submap sm;
+    sm.set_all_ter( t_dirt );
+    sm.set_all_furn( f_null );
+    sm.set_all_traps( tr_null );
+    sm.set_ter( corner_nw, STATIC( ter_str_id( "t_floor_red" ) ).id() );
+    sm.set_furn( corner_se, STATIC( furn_str_id( "f_gas_tank" ) ).id() );
+    sm.set_trap( random_pt, STATIC( trap_str_id( "tr_landmine" ) ).id() );
+    for( int x = 0; x < SEEX; ++x ) {
+        sm.set_radiation( { x, 3 }, x / 4 );
+    }
+    sm.set_radiation( corner_sw, -5 );
+    sm.get_items( random_pt ).insert( item( "rock", calendar::turn_zero ) );
+    sm.get_field( corner_ne ).add_field( STATIC( field_type_str_id( "fd_blood" ) ).id(), 2,
+                                         1_turns );
+    sm.insert_cosmetic( corner_sw, "SIGNAGE", "Welcome" );
+
+    const tripoint pos( 12, -34, 2 );
+    const std::string data = submaps_to_binary( { { pos, &sm } } );
+    REQUIRE( is_binary_submap_data( data ) );
+
+    int loaded = 0;
+    submaps_from_binary( data, [&]( const tripoint & p, std::unique_ptr<submap> &loaded_sm ) {
+        ++loaded;
+        CHECK( p == pos );
+        CHECK( loaded_sm->get_ter( corner_nw ) == STATIC( ter_str_id( "t_floor_red" ) ) );
+        CHECK( loaded_sm->get_radiation( corner_sw ) == -5 );
+        CHECK( submap_as_json( *loaded_sm ) == submap_as_json( sm ) );
+    } );
+    CHECK( loaded == 1 );
+
+    // Anything cut short must be rejected instead of producing a broken submap
+    const std::string truncated = data.substr( 0, data.size() - 1 );
+    CHECK_THROWS( submaps_from_binary( truncated, []( const tripoint &,
+    std::unique_ptr<submap> & ) {} ) );
+    CHECK_FALSE( is_binary_submap_data( "[{\"version\":33}]" ) );
+}
@@ -0,0 +1,138 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "avatar.h"
+#include "calendar.h"
+#include "cata_catch.h"
+#include "cata_utility.h"
+#include "field_type.h"
+#include "game.h"
+#include "item.h"
+#include "json.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "mapdata.h"
+#include "player_helpers.h"
+#include "point.h"
+#include "rng.h"
+#include "turn_profiler.h"
+#include "type_id.h"
+
+// Headless benchmark of the main turn loop.
+//
+// The test is hidden; run it explicitly with
+//   cata_test "[benchmark][do_turn]"
+// The number of simulated turns can be overridden with CATA_TURN_BENCHMARK_TURNS and
+// the JSON report is written to the path in CATA_TURN_BENCHMARK_JSON (stdout otherwise).
+
+static const int default_benchmark_turns = 100;
+
+static int benchmark_turns()
+{
+    const char *env = std::getenv( "CATA_TURN_BENCHMARK_TURNS" );
+    if( env == nullptr ) {
+        return default_benchmark_turns;
+    }
+    const int turns = std::atoi( env );
+    return turns > 0 ? turns : default_benchmark_turns;
+}
+
+// Builds a fixed, deterministic fixture: the avatar sealed in a rock cell in the middle of
+// the reality bubble, surrounded by a horde, some fires, a gas cloud and a pile of items.
+static void build_benchmark_fixture()
+{
+    rng_set_engine_seed( 1234 );
+    clear_avatar();
+    clear_map();
+    calendar::turn = calendar::turn_zero + 12_hours;
+
+    map &here = get_map();
+    avatar &u = get_avatar();
+    const tripoint center( MAPSIZE_X / 2, MAPSIZE_Y / 2, 0 );
+    u.setpos( center );
+
+    for( const tripoint &p : here.points_in_radius( center, 2 ) ) {
+        if( p != center ) {
+            here.ter_set( p, t_rock );
+        }
+    }
+
+    // A ring of zombies at varying distances.
+    int spawned = 0;
+    for( int radius = 6; radius <= 30 && spawned < 200; radius += 3 ) {
+        for( const tripoint &p : here.points_in_radius( center, radius ) ) {
+            if( square_dist( p, center ) != radius || !one_in( 4 ) || spawned >= 200 ) {
+                continue;
+            }
+            spawn_test_monster( "mon_zombie", p );
+            ++spawned;
+        }
+    }
+
+    // Burning and gas-filled patches keep process_fields busy.
+    const tripoint fire_origin = center + tripoint( -20, -20, 0 );
+    for( const tripoint &p : here.points_in_radius( fire_origin, 4 ) ) {
+        here.ter_set( p, t_dirt );
+        here.add_item_or_charges( p, item( "stick" ) );
+        here.add_field( p, fd_fire, 3 );
+    }
+    const tripoint gas_origin = center + tripoint( 20, 20, 0 );
+    for( const tripoint &p : here.points_in_radius( gas_origin, 5 ) ) {
+        here.add_field( p, fd_toxic_gas, 3 );
+        here.add_field( p, fd_smoke, 2 );
+    }
+
+    // Items that rot or tick keep process_items busy.
+    const tripoint item_origin = center + tripoint( 20, -20, 0 );
+    for( const tripoint &p : here.points_in_radius( item_origin, 3 ) ) {
+        here.add_item_or_charges( p, item( "meat_cooked" ) );
+        here.add_item_or_charges( p, item( "milk" ) );
+    }
+}
+
+TEST_CASE( "turn_loop_benchmark", "[.][benchmark][do_turn]" )
+{
+    build_benchmark_fixture();
+    avatar &u = get_avatar();
+    const int turns = benchmark_turns();
+
+    turn_profiler::reset();
+    turn_profiler::set_enabled( true );
+    const auto start = std::chrono::steady_clock::now();
+    for( int i = 0; i < turns; ++i ) {
+        // The test harness has no game mode to advance the calendar, so do it here and
+        // keep the avatar out of the input loop.
+        calendar::turn += 1_turns;
+        g->new_game = true;
+        u.moves = 0;
+        REQUIRE_FALSE( g->do_turn() );
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() -
+            start;
+    turn_profiler::set_enabled( false );
+
+    CHECK( turn_profiler::turns() == turns );
+    CHECK( turn_profiler::get_stats( turn_profiler::phase::monmove ).calls == turns );
+
+    std::ostringstream os;
+    JsonOut jsout( os, true );
+    jsout.start_object();
+    jsout.member( "benchmark", "turn_loop" );
+    jsout.member( "wall_ms", elapsed.count() );
+    jsout.member( "profile" );
+    turn_profiler::serialize( jsout );
+    jsout.end_object();
+
+    const char *out_path = std::getenv( "CATA_TURN_BENCHMARK_JSON" );
+    if( out_path != nullptr ) {
+        write_to_file( out_path, [&os]( std::ostream & fout ) {
+            fout << os.str() << '\n';
+        }, "turn benchmark report" );
+    } else {
+        printf( "%s\n", os.str().c_str() );
+    }
+}
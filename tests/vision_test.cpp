@@ -552,3 +552,51 @@ TEST_CASE( "vision_inside_meth_lab", "[shadowcasting][vision]" )
     t.test_all();
     clear_vehicles();
 }
+
+TEST_CASE( "vision_stationary_light_follows_changes", "[shadowcasting][vision]" )
+{
+    g->place_player( tripoint( 60, 60, 0 ) );
+    clear_map();
+    g->reset_light_level();
+    calendar::turn = midnight;
+
+    map &here = get_map();
+    const tripoint light( 40, 40, 0 );
+    const tripoint wall = light + point_south;
+    const tripoint target = light + point( 0, 3 );
+    const tripoint other_light( 80, 40, 0 );
+    const tripoint other_target = other_light + point( 0, 3 );
+    const ter_id ground = here.ter( light );
+    const auto light_at = [&]( const tripoint & p ) {
+        here.invalidate_map_cache( 0 );
+        here.build_map_cache( 0 );
+        return here.ambient_light_at( p );
+    };
+
+    const float dark = light_at( target );
+    here.ter_set( light, ter_str_id( "t_utility_light" ) );
+    here.ter_set( other_light, ter_str_id( "t_utility_light" ) );
+    const float lit = light_at( target );
+    CHECK( lit > dark );
+    CHECK( light_at( other_target ) == lit );
+    // The light is kept while nothing changes
+    CHECK( light_at( target ) == lit );
+
+    here.ter_set( wall, ter_str_id( "t_wall" ) );
+    CHECK( light_at( target ) < lit );
+    CHECK( light_at( other_target ) == lit );
+    here.ter_set( wall, ground );
+    CHECK( light_at( target ) == lit );
+
+    // The light moves along with the map
+    here.shift( point_east );
+    CHECK( light_at( target - point( SEEX, 0 ) ) == lit );
+    CHECK( light_at( other_target - point( SEEX, 0 ) ) == lit );
+    here.shift( point_west );
+    CHECK( light_at( target ) == lit );
+
+    here.ter_set( light, ground );
+    here.ter_set( other_light, ground );
+    CHECK( light_at( target ) == dark );
+    CHECK( light_at( other_target ) == dark );
+}